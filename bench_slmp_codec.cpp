@@ -0,0 +1,173 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <test_slmp/plc_client.hpp>
+#include <test_slmp/slmp_codec.hpp>
+#include <vector>
+
+using namespace plc_slmp;
+
+// Số lần lặp mỗi phép đo codec
+constexpr int kIterations = 20000;
+
+// Số word mỗi frame trong các phép đo (frame lớn nhất của SLMP)
+constexpr int kWords = kMaxBatchWords;
+
+// Chạy fn kIterations lần, trả về ns cho mỗi word
+template <typename Fn>
+double ns_per_word(Fn fn, int iterations = kIterations) {
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    fn();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - begin).count() /
+         ((double)iterations * kWords);
+}
+
+// Tạo response 3E batch read thành công chứa words (giống PLC trả về)
+std::vector<uint8_t> make_response(SlmpEncoding                 encoding,
+                                   const std::vector<uint16_t> &words) {
+  char header[32];
+  if (encoding == SlmpEncoding::ASCII) {
+    std::vector<uint8_t> frame(22 + words.size() * 4);
+    snprintf(header,
+             sizeof(header),
+             "D00000FF03FF00%04X0000",
+             (unsigned)(4 + words.size() * 4));
+    memcpy(frame.data(), header, 22);
+    encode_hex_words(words.data(), words.size(), (char *)frame.data() + 22);
+    return frame;
+  }
+
+  std::vector<uint8_t> frame(11 + words.size() * 2);
+  size_t               length = 2 + words.size() * 2;
+  const uint8_t        head[] = {0xD0,
+                                 0x00,
+                                 0x00,
+                                 0xFF,
+                                 0xFF,
+                                 0x03,
+                                 0x00,
+                                 (uint8_t)(length & 0xFF),
+                                 (uint8_t)(length >> 8),
+                                 0x00,
+                                 0x00};
+  memcpy(frame.data(), head, sizeof(head));
+  store_le_words(words.data(), words.size(), frame.data() + sizeof(head));
+  return frame;
+}
+
+void bench_codec(SlmpEncoding encoding, const std::vector<uint16_t> &words) {
+  SlmpFrameConfig config;
+  config.encoding = encoding;
+  SlmpCodec codec(config);
+
+  DeviceAddress        start = parse_device_address("D0");
+  std::vector<uint8_t> frame(codec.max_frame_size(kWords));
+  std::vector<uint16_t> out(kWords);
+  std::vector<uint8_t>  response = make_response(encoding, words);
+  volatile size_t       sink     = 0;
+
+  double read_ns = ns_per_word([&]() {
+    sink = codec.encode_read(frame.data(), frame.size(), start, kWords);
+  });
+  double write_ns = ns_per_word([&]() {
+    sink = codec.encode_write(
+      frame.data(), frame.size(), start, kWords, words.data());
+  });
+  bool   decoded   = true;
+  double decode_ns = ns_per_word([&]() {
+    SlmpResponse resp;
+    decoded &= codec.decode_response(response.data(), response.size(), resp) &&
+               codec.decode_words(resp, out.data(), kWords);
+  });
+  (void)sink;
+
+  spdlog::info("{:<6} encode_read {:7.3f} ns/word, encode_write {:7.3f} "
+               "ns/word, decode_words {:7.3f} ns/word{}",
+               encoding == SlmpEncoding::ASCII ? "ASCII" : "binary",
+               read_ns,
+               write_ns,
+               decode_ns,
+               (decoded && out == words) ? "" : " (DECODE MISMATCH)");
+}
+
+void bench_simd(const std::vector<uint16_t> &words) {
+  std::vector<char>     text(kWords * 4);
+  std::vector<uint16_t> out(kWords);
+  encode_hex_words(words.data(), kWords, text.data());
+
+  double scalar_ns = ns_per_word(
+    [&]() { decode_hex_words_scalar(text.data(), kWords, out.data()); });
+  double simd_ns =
+    ns_per_word([&]() { decode_hex_words(text.data(), kWords, out.data()); });
+  spdlog::info("decode_hex_words     scalar {:7.3f} ns/word, SIMD {:7.3f} "
+               "ns/word ({:.1f}x)",
+               scalar_ns,
+               simd_ns,
+               scalar_ns / simd_ns);
+
+  std::vector<uint8_t> nibbles(kWords / 2);
+  std::vector<uint8_t> bits(kWords);
+  for (size_t i = 0; i < nibbles.size(); i++) {
+    nibbles[i] = (uint8_t)(((words[i] & 1) << 4) | ((words[i] >> 1) & 1));
+  }
+  scalar_ns = ns_per_word(
+    [&]() { unpack_bit_nibbles_scalar(nibbles.data(), kWords, bits.data()); });
+  simd_ns = ns_per_word(
+    [&]() { unpack_bit_nibbles(nibbles.data(), kWords, bits.data()); });
+  spdlog::info("unpack_bit_nibbles   scalar {:7.3f} ns/point, SIMD {:7.3f} "
+               "ns/point ({:.1f}x)",
+               scalar_ns,
+               simd_ns,
+               scalar_ns / simd_ns);
+}
+
+// So sánh backend libmelcli và native khi đọc kWords word từ PLC thật
+void bench_backend(const std::string &ip, int port, PlcBackend backend) {
+  const char *name = backend == PlcBackend::NATIVE ? "native" : "libmelcli";
+  PlcClient   plc(ip, port, MELCLI_TYPE_TCPIP);
+  plc.set_backend(backend);
+  if (!plc.init_plc()) {
+    spdlog::error("{} backend: failed to connect to {}:{}", name, ip, port);
+    return;
+  }
+
+  std::vector<uint16_t> data;
+  bool                  ok = true;
+  double                ns = ns_per_word(
+    [&]() { ok &= plc.read_batch_d_registers("D0", kWords, data); }, 200);
+  plc.disconnect();
+  if (!ok) {
+    spdlog::error("{} backend: read failed", name);
+    return;
+  }
+  spdlog::info("{:<9} backend read {} words: {:8.2f} ns/word",
+               name,
+               kWords,
+               ns);
+}
+
+int main(int argc, char **argv) {
+  std::mt19937          gen(42);
+  std::vector<uint16_t> words(kWords);
+  for (auto &w : words) {
+    w = (uint16_t)gen();
+  }
+
+  spdlog::info("SLMP codec benchmark, {} words per frame", kWords);
+  bench_codec(SlmpEncoding::BINARY, words);
+  bench_codec(SlmpEncoding::ASCII, words);
+  bench_simd(words);
+
+  // bench_slmp_codec <ip> <port>: đo thêm cả hai backend với PLC thật
+  if (argc >= 3) {
+    bench_backend(argv[1], atoi(argv[2]), PlcBackend::MELCLI);
+    bench_backend(argv[1], atoi(argv[2]), PlcBackend::NATIVE);
+  }
+  return 0;
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test_slmp/device_address.hpp"
+#include "test_slmp/plc_client.hpp"
+#include "test_slmp/trace.hpp"
+#include "test_slmp/transfer_engine.hpp"
+
+namespace plc_slmp {
+
+// Mô hình độ trễ một frame: latency = per_frame_us + per_word_us * words
+struct LatencyModel {
+  double per_frame_us = 0.0;
+  double per_word_us  = 0.0;
+  size_t samples      = 0;
+
+  inline double predict_us(int words) const {
+    return per_frame_us + per_word_us * words;
+  }
+};
+
+// Cấu hình đo của AutoTuner
+struct AutoTunerConfig {
+  std::string      probe_addr = "D0";  // Vùng đọc thử, phải đọc được
+  std::vector<int> frame_sizes{16, 64, 128, 256, 480, 720, 960};
+  std::vector<int> pipeline_depths{1, 2, 4, 8};  // Chỉ đo với backend native
+  int              repeats = 5;  // Số lần đo mỗi kích thước frame
+  // Chi phí mỗi word của frame được chọn được phép cao hơn frame lớn nhất
+  // bao nhiêu (0.05 = 5%)
+  double           word_cost_slack = 0.05;
+  // Độ trễ dự đoán tối đa của một frame (μs), 0 là không giới hạn
+  double           frame_budget_us = 0.0;
+  std::chrono::milliseconds interval{60000};  // Chu kỳ đo lại khi chạy nền
+};
+
+// Đo độ trễ đọc với các kích thước frame khác nhau trên PLC đang kết nối,
+// fit LatencyModel bằng bình phương tối thiểu rồi cập nhật TransferParams
+// cho TransferEngine (với backend native còn đo thêm pipeline depth). Có
+// thể gọi tune() một lần lúc khởi động hoặc start() để đo lại định kỳ trong
+// thread nền.
+class AutoTuner {
+private:
+  PlcClient              &plc_;
+  TransferEngine         &engine_;
+  AutoTunerConfig         config_;
+  LatencyModel            model_;
+  std::vector<uint16_t>   buffer_;  // Chỉ dùng khi giữ tune_mutex_
+  std::mutex              tune_mutex_;
+  std::mutex              mutex_;
+  std::condition_variable cv_;
+  std::atomic<bool>       running_{false};
+  std::thread             worker_;
+
+  // Số frame mỗi lần đo pipeline depth
+  static constexpr int kDepthProbeFrames = 8;
+
+  // Đọc frames frame cùng kích thước words với pipeline depth, trả về median
+  // độ trễ (μs) hoặc âm nếu lỗi. Các frame cùng đọc một vùng và ghi đè lên
+  // nhau trong buffer_ nên không cần vùng thiết bị lớn.
+  inline double measure_us(const DeviceAddress &start,
+                           int                  words,
+                           int                  frames = 1,
+                           int                  depth  = 1) {
+    WordChunk chunk;
+    format_device_address(start, chunk.addr, sizeof(chunk.addr));
+    chunk.num = words;
+    std::vector<WordChunk> chunks(frames, chunk);
+
+    std::vector<double> samples;
+    for (int i = 0; i < config_.repeats; i++) {
+      auto begin = std::chrono::steady_clock::now();
+      if (!plc_.read_chunks(
+            chunks.data(), chunks.size(), buffer_.data(), depth)) {
+        return -1.0;
+      }
+      auto end = std::chrono::steady_clock::now();
+      samples.push_back(
+        std::chrono::duration<double, std::micro>(end - begin).count());
+    }
+    std::nth_element(
+      samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+  }
+
+protected:
+  // Chọn tham số từ mô hình. Chi phí mỗi word per_frame_us / n +
+  // per_word_us luôn giảm theo n nên frame lớn nhất luôn rẻ nhất; frame
+  // được chọn là frame nhỏ nhất có chi phí mỗi word không quá
+  // (1 + word_cost_slack) lần chi phí tại kMaxBatchWords, vì frame nhỏ giữ
+  // mutex của PlcClient ngắn hơn. frame_budget_us (nếu có) giới hạn thêm
+  // độ trễ dự đoán của một frame. Khoảng gộp bằng số word có chi phí
+  // truyền tương đương một frame.
+  inline TransferParams choose_params(const LatencyModel &model) {
+    TransferParams params;
+    const double   slack = std::max(0.0, config_.word_cost_slack);
+    const double   max_cost =
+      model.per_frame_us / kMaxBatchWords + model.per_word_us;
+    const double margin = (1.0 + slack) * max_cost - model.per_word_us;
+    double       words  = kMaxBatchWords;
+    if (margin > 0.0) {
+      words = std::ceil(model.per_frame_us / margin);
+    }
+    if (config_.frame_budget_us > 0.0 && model.per_word_us > 0.0) {
+      words = std::min(
+        words,
+        std::floor((config_.frame_budget_us - model.per_frame_us) /
+                   model.per_word_us));
+    }
+    const int smallest = *std::min_element(config_.frame_sizes.begin(),
+                                           config_.frame_sizes.end());
+    params.max_frame_words =
+      (int)std::max((double)smallest, std::min(words, (double)kMaxBatchWords));
+
+    if (model.per_word_us > 0.0) {
+      double gap          = model.per_frame_us / model.per_word_us;
+      params.coalesce_gap = (int)std::min(gap, (double)params.max_frame_words);
+    } else {
+      params.coalesce_gap = params.max_frame_words;
+    }
+    return params;
+  }
+
+public:
+  AutoTuner(PlcClient      &plc,
+            TransferEngine &engine,
+            AutoTunerConfig config = {})
+    : plc_(plc), engine_(engine), config_(config) {
+    config_.frame_sizes.erase(
+      std::remove_if(config_.frame_sizes.begin(),
+                     config_.frame_sizes.end(),
+                     [](int s) { return s <= 0 || s > kMaxBatchWords; }),
+      config_.frame_sizes.end());
+    config_.pipeline_depths.erase(
+      std::remove_if(config_.pipeline_depths.begin(),
+                     config_.pipeline_depths.end(),
+                     [](int d) { return d <= 0 || d > kMaxPipelineDepth; }),
+      config_.pipeline_depths.end());
+    if (config_.repeats <= 0) {
+      config_.repeats = 1;
+    }
+    buffer_.resize(kMaxBatchWords);
+  }
+
+  ~AutoTuner() {
+    stop();
+  }
+
+  // Đo, fit mô hình và áp dụng tham số mới cho engine. Trả về false và giữ
+  // nguyên tham số cũ nếu có lần đọc thử bị lỗi. Gọi được trong lúc start()
+  // đang chạy, các lần đo được thực hiện lần lượt.
+  inline bool tune() {
+    SLMP_TRACE_SCOPE("tune", "tuner");
+    std::lock_guard<std::mutex> tune_lock(tune_mutex_);
+    DeviceAddress start = parse_device_address(config_.probe_addr.c_str());
+    if (!start.valid() || config_.frame_sizes.size() < 2) {
+      std::cerr << "Invalid auto tuner configuration" << std::endl;
+      return false;
+    }
+
+    std::vector<double> medians;
+    for (int words : config_.frame_sizes) {
+      double latency = measure_us(start, words);
+      if (latency < 0.0) {
+        std::cerr << "Auto tuner probe failed at " << words << " words"
+                  << std::endl;
+        return false;
+      }
+      medians.push_back(latency);
+    }
+
+    // Bình phương tối thiểu trên median của từng kích thước frame
+    double n = (double)medians.size();
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    for (size_t i = 0; i < medians.size(); i++) {
+      double x = config_.frame_sizes[i];
+      sx += x;
+      sy += medians[i];
+      sxx += x * x;
+      sxy += x * medians[i];
+    }
+    LatencyModel model;
+    double       denom = n * sxx - sx * sx;
+    if (denom > 0.0) {
+      model.per_word_us = std::max(0.0, (n * sxy - sx * sy) / denom);
+    }
+    model.per_frame_us = std::max(0.0, (sy - model.per_word_us * sx) / n);
+    model.samples      = medians.size() * config_.repeats;
+
+    TransferParams params = choose_params(model);
+
+    // Pipeline depth chỉ có tác dụng với backend native: chọn depth nhỏ nhất
+    // mà thời gian đọc kDepthProbeFrames frame không chậm hơn 5% so với
+    // depth nhanh nhất
+    if (plc_.backend() == PlcBackend::NATIVE) {
+      std::vector<double> depth_us;
+      double              best = -1.0;
+      for (int depth : config_.pipeline_depths) {
+        double latency =
+          measure_us(start, params.max_frame_words, kDepthProbeFrames, depth);
+        if (latency < 0.0) {
+          std::cerr << "Auto tuner probe failed at pipeline depth " << depth
+                    << std::endl;
+          return false;
+        }
+        depth_us.push_back(latency);
+        if (best < 0.0 || latency < best) {
+          best = latency;
+        }
+      }
+      for (size_t i = 0; i < depth_us.size(); i++) {
+        if (depth_us[i] <= best * 1.05) {
+          params.pipeline_depth = config_.pipeline_depths[i];
+          break;
+        }
+      }
+    }
+    engine_.set_params(params);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    model_ = model;
+    return true;
+  }
+
+  inline LatencyModel model() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return model_;
+  }
+
+  // Chạy tune() định kỳ theo config.interval trong thread nền
+  inline void start() {
+    if (running_.exchange(true)) {
+      return;
+    }
+    worker_ = std::thread([this]() {
+      while (running_) {
+        tune();
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, config_.interval, [this]() { return !running_; });
+      }
+    });
+  }
+
+  inline void stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!running_.exchange(false)) {
+        return;
+      }
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+      worker_.join();
+    }
+  }
+};
+
+}  // namespace plc_slmp
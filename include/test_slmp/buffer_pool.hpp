@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace plc_slmp {
+
+// Kích thước một cache line, mọi slab đều căn theo giá trị này
+constexpr size_t kCacheLineSize = 64;
+
+// Một slab đủ chứa frame lớn nhất (960 word ở chế độ ASCII kèm header)
+constexpr size_t kDefaultSlabBytes = 4096;
+constexpr size_t kDefaultSlabCount = 8;
+
+// Thống kê sử dụng pool để chọn kích thước phù hợp
+struct BufferPoolStats {
+  size_t   slab_count = 0;  // Số slab cấp sẵn
+  size_t   slab_bytes = 0;  // Kích thước mỗi slab
+  size_t   in_use     = 0;  // Số slab đang được giữ
+  size_t   high_water = 0;  // Số slab được giữ đồng thời nhiều nhất
+  uint64_t acquires   = 0;  // Tổng số lần lấy buffer
+  uint64_t fallbacks  = 0;  // Số lần pool cạn hoặc yêu cầu quá lớn, phải
+                            // cấp phát trên heap
+};
+
+// Phần dữ liệu của BufferPool: vùng nhớ các slab, danh sách slab trống và
+// thống kê. BufferPool và mọi PooledBuffer đang giữ slab cùng sở hữu nó qua
+// shared_ptr, nên buffer sống lâu hơn pool (hoặc PlcClient chứa pool) vẫn
+// hợp lệ và trả slab về đúng chỗ.
+class BufferPoolState {
+private:
+  struct AlignedFree {
+    void operator()(unsigned char *p) const {
+      std::free(p);
+    }
+  };
+
+  std::unique_ptr<unsigned char, AlignedFree> storage_;
+  size_t                                      slab_bytes_;
+  size_t                                      slab_count_;
+  std::vector<int>                            free_;
+  BufferPoolStats                             stats_;
+  std::mutex                                  mutex_;
+
+  friend class BufferPool;
+  friend class PooledBuffer;
+
+  static inline unsigned char *aligned_alloc_bytes(size_t bytes) {
+    size_t rounded = (bytes + kCacheLineSize - 1) / kCacheLineSize *
+                     kCacheLineSize;
+    return static_cast<unsigned char *>(
+      std::aligned_alloc(kCacheLineSize, rounded == 0 ? kCacheLineSize
+                                                      : rounded));
+  }
+
+  inline void give_back(unsigned char *data, int index) {
+    if (index < 0) {
+      std::free(data);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= 0) {
+      free_.push_back(index);
+    }
+    stats_.in_use--;
+  }
+
+public:
+  BufferPoolState(size_t slab_count, size_t slab_bytes)
+    : slab_bytes_((slab_bytes + kCacheLineSize - 1) / kCacheLineSize *
+                  kCacheLineSize),
+      slab_count_(slab_count) {
+    storage_.reset(aligned_alloc_bytes(slab_bytes_ * slab_count_));
+    free_.reserve(slab_count_);
+    for (size_t i = slab_count_; i > 0; i--) {
+      free_.push_back((int)(i - 1));
+    }
+    stats_.slab_count = slab_count_;
+    stats_.slab_bytes = slab_bytes_;
+  }
+
+  BufferPoolState(const BufferPoolState &)            = delete;
+  BufferPoolState &operator=(const BufferPoolState &) = delete;
+};
+
+// Buffer lấy từ BufferPool, tự trả về pool khi hủy. Chỉ move, không copy.
+class PooledBuffer {
+private:
+  friend class BufferPool;
+
+  std::shared_ptr<BufferPoolState> pool_;
+  unsigned char                   *data_  = nullptr;
+  size_t                           size_  = 0;
+  int                              index_ = -1;  // -1: cấp phát riêng
+
+  PooledBuffer(std::shared_ptr<BufferPoolState> pool,
+               unsigned char                   *data,
+               size_t                           size,
+               int                              index)
+    : pool_(std::move(pool)), data_(data), size_(size), index_(index) {
+  }
+
+public:
+  PooledBuffer() = default;
+  PooledBuffer(const PooledBuffer &)            = delete;
+  PooledBuffer &operator=(const PooledBuffer &) = delete;
+
+  PooledBuffer(PooledBuffer &&other) noexcept {
+    *this = std::move(other);
+  }
+
+  PooledBuffer &operator=(PooledBuffer &&other) noexcept {
+    if (this != &other) {
+      release();
+      pool_        = std::move(other.pool_);
+      data_        = other.data_;
+      size_        = other.size_;
+      index_       = other.index_;
+      other.data_  = nullptr;
+      other.size_  = 0;
+      other.index_ = -1;
+    }
+    return *this;
+  }
+
+  ~PooledBuffer() {
+    release();
+  }
+
+  // Trả slab về pool ngay, buffer trở thành rỗng
+  inline void release() {
+    if (pool_ != nullptr && data_ != nullptr) {
+      pool_->give_back(data_, index_);
+    }
+    pool_.reset();
+    data_  = nullptr;
+    size_  = 0;
+    index_ = -1;
+  }
+
+  inline unsigned char *data() const {
+    return data_;
+  }
+
+  inline uint16_t *words() const {
+    return reinterpret_cast<uint16_t *>(data_);
+  }
+
+  inline size_t size() const {
+    return size_;
+  }
+
+  inline explicit operator bool() const {
+    return data_ != nullptr;
+  }
+};
+
+// Pool cố định gồm các slab căn theo cache line, cấp phát một lần khi khởi
+// tạo. acquire()/release() chỉ thao tác trên danh sách slab trống đã reserve
+// sẵn nên không gọi malloc, trừ khi pool cạn (được đếm trong fallbacks).
+// Vùng nhớ slab được giải phóng khi cả pool lẫn buffer cuối cùng lấy từ nó
+// đã bị hủy.
+class BufferPool {
+private:
+  std::shared_ptr<BufferPoolState> state_;
+
+public:
+  BufferPool(size_t slab_count = kDefaultSlabCount,
+             size_t slab_bytes = kDefaultSlabBytes)
+    : state_(std::make_shared<BufferPoolState>(slab_count, slab_bytes)) {
+  }
+
+  BufferPool(const BufferPool &)            = delete;
+  BufferPool &operator=(const BufferPool &) = delete;
+
+  // Lấy buffer ít nhất bytes byte. Trả về slab của pool nếu còn và đủ lớn,
+  // ngược lại cấp phát riêng trên heap. Buffer rỗng nếu cấp phát thất bại.
+  inline PooledBuffer acquire(size_t bytes = 0) {
+    BufferPoolState &state = *state_;
+    int              index = -1;
+    {
+      std::lock_guard<std::mutex> lock(state.mutex_);
+      state.stats_.acquires++;
+      if (bytes <= state.slab_bytes_ && !state.free_.empty()) {
+        index = state.free_.back();
+        state.free_.pop_back();
+      } else {
+        state.stats_.fallbacks++;
+      }
+      state.stats_.in_use++;
+      if (state.stats_.in_use > state.stats_.high_water) {
+        state.stats_.high_water = state.stats_.in_use;
+      }
+    }
+
+    if (index >= 0) {
+      return PooledBuffer(state_,
+                          state.storage_.get() +
+                            (size_t)index * state.slab_bytes_,
+                          state.slab_bytes_,
+                          index);
+    }
+
+    size_t size = bytes > state.slab_bytes_ ? bytes : state.slab_bytes_;
+    unsigned char *data = BufferPoolState::aligned_alloc_bytes(size);
+    if (data == nullptr) {
+      std::lock_guard<std::mutex> lock(state.mutex_);
+      state.stats_.in_use--;
+      return PooledBuffer();
+    }
+    return PooledBuffer(state_, data, size, -1);
+  }
+
+  inline BufferPoolStats stats() {
+    std::lock_guard<std::mutex> lock(state_->mutex_);
+    return state_->stats_;
+  }
+
+  inline size_t slab_bytes() const {
+    return state_->slab_bytes_;
+  }
+};
+
+}  // namespace plc_slmp
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace plc_slmp {
+
+// Enum cho các loại thanh ghi PLC
+enum class RegisterType {
+  D_REGISTER,   // Data register (D0, D100, D1000, ...)
+  X_REGISTER,   // Input register (X0, X1, X10, X100, ...)
+  Y_REGISTER,   // Output register (Y0, Y1, Y10, Y100, ...)
+  M_REGISTER,   // Memory register (M0, M1, M100, ...)
+  B_REGISTER,   // Link register (B0, B1, B10, ...)
+  SD_REGISTER,  // SD register (SD0, SD1, SD10, SD100, ...)
+  UNKNOWN
+};
+
+// Số word tối đa trong một frame batch read/write (3E/4E, đơn vị word)
+constexpr int kMaxBatchWords = 960;
+
+// Độ dài tối đa của chuỗi địa chỉ, tính cả ký tự '\0' ("SD16777215")
+constexpr size_t kMaxAddressLength = 16;
+
+// Số hiệu thiết bị trong SLMP dài 3 byte
+constexpr uint32_t kMaxDeviceNumber = 0xFFFFFF;
+
+// Địa chỉ đã tách thành loại thanh ghi và số hiệu
+struct DeviceAddress {
+  RegisterType type   = RegisterType::UNKNOWN;
+  uint32_t     number = 0;
+
+  constexpr bool valid() const {
+    return type != RegisterType::UNKNOWN;
+  }
+};
+
+// Thiết bị bit (X, Y, M, B) đọc theo word: mỗi word chứa 16 điểm
+constexpr bool is_bit_device(RegisterType type) {
+  return type == RegisterType::X_REGISTER ||
+         type == RegisterType::Y_REGISTER ||
+         type == RegisterType::M_REGISTER || type == RegisterType::B_REGISTER;
+}
+
+// Số điểm thiết bị ứng với một word khi đọc/ghi theo đơn vị word
+constexpr uint32_t points_per_word(RegisterType type) {
+  return is_bit_device(type) ? 16 : 1;
+}
+
+// X, Y, B đánh số hệ 16, các thiết bị còn lại hệ 10
+constexpr uint32_t device_number_base(RegisterType type) {
+  return (type == RegisterType::X_REGISTER ||
+          type == RegisterType::Y_REGISTER || type == RegisterType::B_REGISTER)
+           ? 16
+           : 10;
+}
+
+constexpr const char *device_prefix(RegisterType type) {
+  switch (type) {
+    case RegisterType::D_REGISTER:
+      return "D";
+    case RegisterType::X_REGISTER:
+      return "X";
+    case RegisterType::Y_REGISTER:
+      return "Y";
+    case RegisterType::M_REGISTER:
+      return "M";
+    case RegisterType::B_REGISTER:
+      return "B";
+    case RegisterType::SD_REGISTER:
+      return "SD";
+    default:
+      return "";
+  }
+}
+
+// Tách "D100" thành {D_REGISTER, 100}. Trả về type UNKNOWN nếu sai định dạng
+// hoặc số hiệu vượt quá kMaxDeviceNumber. Không cấp phát, dùng được lúc
+// compile time.
+constexpr DeviceAddress parse_device_address(const char *addr) {
+  DeviceAddress result;
+  if (addr == nullptr) {
+    return result;
+  }
+
+  RegisterType type   = RegisterType::UNKNOWN;
+  const char  *digits = addr + 1;
+  switch (addr[0]) {
+    case 'D':
+      type = RegisterType::D_REGISTER;
+      break;
+    case 'X':
+      type = RegisterType::X_REGISTER;
+      break;
+    case 'Y':
+      type = RegisterType::Y_REGISTER;
+      break;
+    case 'M':
+      type = RegisterType::M_REGISTER;
+      break;
+    case 'B':
+      type = RegisterType::B_REGISTER;
+      break;
+    case 'S':
+      if (addr[1] == 'D') {
+        type   = RegisterType::SD_REGISTER;
+        digits = addr + 2;
+      }
+      break;
+    default:
+      break;
+  }
+  if (type == RegisterType::UNKNOWN || *digits == '\0') {
+    return result;
+  }
+
+  const uint32_t base   = device_number_base(type);
+  uint32_t       number = 0;
+  for (const char *p = digits; *p != '\0'; p++) {
+    uint32_t digit = 0;
+    if (*p >= '0' && *p <= '9') {
+      digit = (uint32_t)(*p - '0');
+    } else if (base == 16 && *p >= 'A' && *p <= 'F') {
+      digit = (uint32_t)(*p - 'A' + 10);
+    } else if (base == 16 && *p >= 'a' && *p <= 'f') {
+      digit = (uint32_t)(*p - 'a' + 10);
+    } else {
+      return result;
+    }
+    number = number * base + digit;
+    if (number > kMaxDeviceNumber) {
+      return result;
+    }
+  }
+
+  result.type   = type;
+  result.number = number;
+  return result;
+}
+
+// Xác định loại thanh ghi theo đúng định dạng mà PlcClient chấp nhận:
+// D\d+, X/Y/B[0-9A-Fa-f]+, M\d+, SD[0-9A-Fa-f]+. Không cấp phát, không giới
+// hạn số hiệu (khác parse_device_address).
+constexpr RegisterType classify_register_address(const char *addr) {
+  if (addr == nullptr) {
+    return RegisterType::UNKNOWN;
+  }
+
+  RegisterType type   = RegisterType::UNKNOWN;
+  const char  *digits = addr + 1;
+  bool         hex    = true;
+  switch (addr[0]) {
+    case 'D':
+      type = RegisterType::D_REGISTER;
+      hex  = false;
+      break;
+    case 'X':
+      type = RegisterType::X_REGISTER;
+      break;
+    case 'Y':
+      type = RegisterType::Y_REGISTER;
+      break;
+    case 'M':
+      type = RegisterType::M_REGISTER;
+      hex  = false;
+      break;
+    case 'B':
+      type = RegisterType::B_REGISTER;
+      break;
+    case 'S':
+      if (addr[1] == 'D') {
+        type   = RegisterType::SD_REGISTER;
+        digits = addr + 2;
+      }
+      break;
+    default:
+      break;
+  }
+  if (type == RegisterType::UNKNOWN || *digits == '\0') {
+    return RegisterType::UNKNOWN;
+  }
+
+  for (const char *p = digits; *p != '\0'; p++) {
+    bool is_digit = *p >= '0' && *p <= '9';
+    bool is_hex   = (*p >= 'A' && *p <= 'F') || (*p >= 'a' && *p <= 'f');
+    if (!is_digit && !(hex && is_hex)) {
+      return RegisterType::UNKNOWN;
+    }
+  }
+  return type;
+}
+
+// Ghi địa chỉ dạng chuỗi ("D100", "X1F") vào buf, trả về số ký tự đã ghi
+// (không tính '\0') hoặc 0 nếu buf không đủ chỗ.
+constexpr size_t format_device_address(const DeviceAddress &addr,
+                                       char                *buf,
+                                       size_t               size) {
+  if (!addr.valid() || addr.number > kMaxDeviceNumber) {
+    return 0;
+  }
+
+  char     digits[8] = {};
+  size_t   ndigits   = 0;
+  uint32_t base      = device_number_base(addr.type);
+  uint32_t number    = addr.number;
+  do {
+    uint32_t digit    = number % base;
+    digits[ndigits++] = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+    number /= base;
+  } while (number != 0);
+
+  const char *prefix = device_prefix(addr.type);
+  size_t      len    = 0;
+  while (prefix[len] != '\0') {
+    len++;
+  }
+  if (len + ndigits + 1 > size) {
+    return 0;
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    buf[i] = prefix[i];
+  }
+  for (size_t i = 0; i < ndigits; i++) {
+    buf[len + i] = digits[ndigits - 1 - i];
+  }
+  buf[len + ndigits] = '\0';
+  return len + ndigits;
+}
+
+}  // namespace plc_slmp
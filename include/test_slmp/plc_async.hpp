@@ -0,0 +1,859 @@
+#pragma once
+
+#if __cplusplus < 202002L || !defined(__cpp_impl_coroutine)
+#error "test_slmp/plc_async.hpp requires C++20 coroutines"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "test_slmp/device_address.hpp"
+#include "test_slmp/plc_client.hpp"
+#include "test_slmp/slmp_codec.hpp"
+#include "test_slmp/slmp_transport.hpp"
+#include "test_slmp/trace.hpp"
+
+namespace plc_slmp {
+
+class PlcEventLoop;
+class AsyncPlcClient;
+
+// Phần chung của promise PlcTask: continuation được resume khi task xong
+// và exception (nếu có) được ném lại cho coroutine đang co_await
+struct PlcPromiseBase {
+  std::coroutine_handle<> continuation;
+  std::exception_ptr      exception;
+
+  std::suspend_always initial_suspend() noexcept {
+    return {};
+  }
+
+  void unhandled_exception() noexcept {
+    exception = std::current_exception();
+  }
+};
+
+template <typename T>
+struct PlcPromiseValue {
+  std::optional<T> value;
+
+  void return_value(T v) {
+    value = std::move(v);
+  }
+
+  T take() {
+    return std::move(*value);
+  }
+};
+
+template <>
+struct PlcPromiseValue<void> {
+  void return_void() {
+  }
+
+  void take() {
+  }
+};
+
+// Coroutine trả về T. Chạy lazy: chỉ bắt đầu khi được co_await hoặc đưa
+// vào PlcEventLoop::spawn(), và chuyển thẳng về coroutine đang chờ khi
+// xong (symmetric transfer) nên chuỗi co_await không làm sâu stack.
+template <typename T = void>
+class PlcTask {
+public:
+  struct promise_type : PlcPromiseBase, PlcPromiseValue<T> {
+    PlcTask get_return_object() {
+      return PlcTask(
+        std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    auto final_suspend() noexcept {
+      struct FinalAwaiter {
+        bool await_ready() const noexcept {
+          return false;
+        }
+
+        std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<promise_type> handle) noexcept {
+          std::coroutine_handle<> next = handle.promise().continuation;
+          return next ? next : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {
+        }
+      };
+      return FinalAwaiter{};
+    }
+  };
+
+private:
+  std::coroutine_handle<promise_type> handle_;
+
+  explicit PlcTask(std::coroutine_handle<promise_type> handle)
+    : handle_(handle) {
+  }
+
+public:
+  PlcTask() = default;
+  PlcTask(const PlcTask &)            = delete;
+  PlcTask &operator=(const PlcTask &) = delete;
+
+  PlcTask(PlcTask &&other) noexcept
+    : handle_(std::exchange(other.handle_, nullptr)) {
+  }
+
+  PlcTask &operator=(PlcTask &&other) noexcept {
+    if (this != &other) {
+      if (handle_) {
+        handle_.destroy();
+      }
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+
+  ~PlcTask() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  auto operator co_await() noexcept {
+    struct Awaiter {
+      std::coroutine_handle<promise_type> handle;
+
+      bool await_ready() const noexcept {
+        return !handle || handle.done();
+      }
+
+      std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+
+      T await_resume() {
+        if (handle.promise().exception) {
+          std::rethrow_exception(handle.promise().exception);
+        }
+        return handle.promise().take();
+      }
+    };
+    return Awaiter{handle_};
+  }
+};
+
+// Vòng lặp sự kiện epoll một thread cho các AsyncPlcClient. Mọi coroutine
+// spawn vào loop và mọi thao tác trên client gắn với loop đều chạy trên
+// thread gọi run(); muốn dùng nhiều thread thì tạo nhiều loop, mỗi loop có
+// client riêng.
+class PlcEventLoop {
+private:
+  friend class AsyncPlcClient;
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Timer {
+    Clock::time_point       deadline;
+    uint64_t                seq;
+    std::coroutine_handle<> handle;
+
+    bool operator>(const Timer &other) const {
+      return deadline != other.deadline ? deadline > other.deadline
+                                        : seq > other.seq;
+    }
+  };
+
+  // Coroutine bọc task được spawn, tự hủy khi xong
+  struct Detached {
+    struct promise_type {
+      Detached get_return_object() {
+        return {};
+      }
+
+      std::suspend_never initial_suspend() noexcept {
+        return {};
+      }
+
+      std::suspend_never final_suspend() noexcept {
+        return {};
+      }
+
+      void return_void() {
+      }
+
+      void unhandled_exception() noexcept {
+        std::terminate();
+      }
+    };
+  };
+
+  int                                 epoll_fd_ = -1;
+  int                                 wake_fd_  = -1;
+  std::mutex                          mutex_;
+  std::vector<PlcTask<void>>          incoming_;  // spawn() từ thread khác
+  std::deque<std::coroutine_handle<>> ready_;
+  std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+  uint64_t                     timer_seq_ = 0;
+  std::vector<AsyncPlcClient *> clients_;
+  std::atomic<size_t>          alive_{0};
+  std::atomic<bool>            stop_{false};
+
+  static Detached run_detached(PlcEventLoop *loop, PlcTask<void> task) {
+    try {
+      co_await task;
+    } catch (const std::exception &e) {
+      std::cerr << "Unhandled exception in PLC task: " << e.what()
+                << std::endl;
+    }
+    loop->alive_--;
+  }
+
+  inline void schedule(std::coroutine_handle<> handle) {
+    ready_.push_back(handle);
+  }
+
+  inline bool watch(int fd, AsyncPlcClient *client, uint32_t events) {
+    epoll_event ev{};
+    ev.events   = events;
+    ev.data.ptr = client;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+      std::cerr << "Failed to watch socket: " << strerror(errno) << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  inline void rewatch(int fd, AsyncPlcClient *client, uint32_t events) {
+    epoll_event ev{};
+    ev.events   = events;
+    ev.data.ptr = client;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+  }
+
+  inline void unwatch(int fd) {
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  }
+
+  inline void wake() {
+    uint64_t one = 1;
+    ssize_t  n   = ::write(wake_fd_, &one, sizeof(one));
+    (void)n;
+  }
+
+  inline void start_incoming() {
+    std::vector<PlcTask<void>> tasks;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks.swap(incoming_);
+    }
+    for (auto &task : tasks) {
+      run_detached(this, std::move(task));
+    }
+  }
+
+  inline void fire_timers(Clock::time_point now) {
+    while (!timers_.empty() && timers_.top().deadline <= now) {
+      schedule(timers_.top().handle);
+      timers_.pop();
+    }
+  }
+
+  inline void drain_ready() {
+    SLMP_TRACE_SCOPE("resume_tasks", "async");
+    while (!ready_.empty()) {
+      std::coroutine_handle<> handle = ready_.front();
+      ready_.pop_front();
+      handle.resume();
+    }
+  }
+
+  inline void check_timeouts(Clock::time_point now);
+  inline int  wait_timeout_ms(Clock::time_point now);
+  inline void dispatch(AsyncPlcClient *client, uint32_t events);
+
+public:
+  PlcEventLoop() {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || wake_fd_ < 0) {
+      std::cerr << "Failed to create event loop: " << strerror(errno)
+                << std::endl;
+      return;
+    }
+    epoll_event ev{};
+    ev.events   = EPOLLIN;
+    ev.data.ptr = nullptr;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+  }
+
+  PlcEventLoop(const PlcEventLoop &)            = delete;
+  PlcEventLoop &operator=(const PlcEventLoop &) = delete;
+
+  // Task còn đang chờ khi loop bị hủy (sau stop()) không được giải phóng
+  ~PlcEventLoop() {
+    if (wake_fd_ >= 0) {
+      ::close(wake_fd_);
+    }
+    if (epoll_fd_ >= 0) {
+      ::close(epoll_fd_);
+    }
+  }
+
+  // Đưa task vào loop. Gọi được từ bất kỳ thread nào.
+  inline void spawn(PlcTask<void> task) {
+    alive_++;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      incoming_.push_back(std::move(task));
+    }
+    wake();
+  }
+
+  // Chạy trên thread hiện tại tới khi mọi task đã spawn kết thúc hoặc
+  // stop() được gọi. stop() gọi trước run() làm run() trả về ngay; cờ dừng
+  // được xóa khi run() trả về nên có thể gọi run() lại.
+  inline void run() {
+    epoll_event events[64];
+    while (!stop_) {
+      start_incoming();
+      Clock::time_point now = Clock::now();
+      fire_timers(now);
+      check_timeouts(now);
+      drain_ready();
+      if (alive_ == 0) {
+        break;
+      }
+
+      int n = epoll_wait(epoll_fd_, events, 64, wait_timeout_ms(Clock::now()));
+      if (n < 0 && errno != EINTR) {
+        std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+        break;
+      }
+      for (int i = 0; i < n; i++) {
+        if (events[i].data.ptr == nullptr) {
+          uint64_t count;
+          ssize_t  r = ::read(wake_fd_, &count, sizeof(count));
+          (void)r;
+        } else {
+          dispatch((AsyncPlcClient *)events[i].data.ptr, events[i].events);
+        }
+      }
+      drain_ready();
+    }
+    stop_ = false;
+  }
+
+  // Yêu cầu run() dừng. Gọi được từ bất kỳ thread nào.
+  inline void stop() {
+    stop_ = true;
+    wake();
+  }
+
+  inline size_t tasks_alive() const {
+    return alive_;
+  }
+
+  // co_await loop.sleep_for(10ms): tạm dừng coroutine mà không chặn thread
+  template <typename Rep, typename Period>
+  inline auto sleep_for(std::chrono::duration<Rep, Period> duration) {
+    struct SleepAwaiter {
+      PlcEventLoop     &loop;
+      Clock::time_point deadline;
+
+      bool await_ready() const noexcept {
+        return deadline <= Clock::now();
+      }
+
+      void await_suspend(std::coroutine_handle<> handle) {
+        loop.timers_.push({deadline, loop.timer_seq_++, handle});
+      }
+
+      void await_resume() const noexcept {
+      }
+    };
+    return SleepAwaiter{
+      *this,
+      Clock::now() + std::chrono::duration_cast<Clock::duration>(duration)};
+  }
+};
+
+// PlcClient dạng awaitable: co_await client.read(...) / write(...) trả về
+// bool như các hàm của PlcClient nhưng chỉ tạm dừng coroutine, không chặn
+// thread. Dùng codec SLMP native trên socket non-blocking; tối đa
+// pipeline_depth frame được gửi trước khi có response, response được ghép
+// theo serial (frame 4E, nên dùng với UDP) hoặc theo thứ tự (frame 3E). UDP
+// với frame 3E chỉ gửi từng frame một.
+// Chỉ dùng client trên thread đang chạy loop của nó.
+class AsyncPlcClient {
+private:
+  friend class PlcEventLoop;
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Request {
+    bool                    write = false;
+    DeviceAddress           start;
+    int                     num        = 0;
+    uint16_t               *read_data  = nullptr;
+    const uint16_t         *write_data = nullptr;
+    uint16_t                serial     = 0;
+    bool                    ok         = false;
+    Clock::time_point       deadline;
+    std::coroutine_handle<> handle;
+  };
+
+  PlcEventLoop        &loop_;
+  std::string          target_ip_addr_;
+  int                  target_port_;
+  bool                 udp_;
+  SlmpCodec            codec_;
+  SlmpSocket           socket_;
+  int                  timeout_ms_;
+  int                  pipeline_depth_;
+  uint16_t             serial_ = 0;
+  bool                 want_write_ = false;
+  std::deque<Request *> queued_;
+  std::deque<Request *> in_flight_;
+  std::vector<uint8_t> tx_;
+  size_t               tx_len_  = 0;
+  size_t               tx_sent_ = 0;
+  std::vector<uint8_t> rx_;
+  size_t               rx_len_ = 0;
+
+  inline void complete(Request *req, bool ok) {
+    req->ok = ok;
+    loop_.schedule(req->handle);
+  }
+
+  // Đóng kết nối và trả lỗi cho mọi request đang chờ
+  inline void fail_all(const char *reason) {
+    if (reason != nullptr) {
+      std::cerr << "PLC connection " << target_ip_addr_ << ":" << target_port_
+                << " closed: " << reason << std::endl;
+    }
+    if (socket_.is_open()) {
+      loop_.unwatch(socket_.fd());
+      socket_.close();
+    }
+    for (Request *req : in_flight_) {
+      complete(req, false);
+    }
+    for (Request *req : queued_) {
+      complete(req, false);
+    }
+    in_flight_.clear();
+    queued_.clear();
+    tx_len_ = tx_sent_ = rx_len_ = 0;
+    want_write_                  = false;
+  }
+
+  inline void set_want_write(bool want) {
+    if (want != want_write_ && socket_.is_open()) {
+      want_write_ = want;
+      loop_.rewatch(
+        socket_.fd(), this, EPOLLIN | (want ? (uint32_t)EPOLLOUT : 0u));
+    }
+  }
+
+  // Encode req vào cuối tx_, trả về độ dài frame hoặc 0 nếu lỗi
+  inline size_t encode(Request *req) {
+    SLMP_TRACE_SCOPE_WORDS("encode", "async", req->num);
+    size_t need = codec_.max_frame_size(req->write ? req->num : 0);
+    if (tx_.size() < tx_len_ + need) {
+      tx_.resize(tx_len_ + need);
+    }
+    uint8_t *buf = tx_.data() + tx_len_;
+    req->serial  = serial_++;
+    req->deadline =
+      Clock::now() + std::chrono::milliseconds(timeout_ms_);
+    return req->write ? codec_.encode_write(buf,
+                                            need,
+                                            req->start,
+                                            req->num,
+                                            req->write_data,
+                                            req->serial)
+                      : codec_.encode_read(
+                          buf, need, req->start, req->num, req->serial);
+  }
+
+  // Gửi phần còn lại của tx_ (TCP). Khi socket đầy thì chờ EPOLLOUT.
+  inline void flush() {
+    while (tx_sent_ < tx_len_) {
+      ssize_t n = ::send(socket_.fd(),
+                         tx_.data() + tx_sent_,
+                         tx_len_ - tx_sent_,
+                         MSG_NOSIGNAL | MSG_DONTWAIT);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        set_want_write(true);
+        return;
+      }
+      if (n <= 0) {
+        fail_all(strerror(errno));
+        return;
+      }
+      tx_sent_ += (size_t)n;
+    }
+    tx_len_ = tx_sent_ = 0;
+    set_want_write(false);
+  }
+
+  // Chuyển request từ hàng đợi sang đang gửi khi còn chỗ trong pipeline
+  inline void pump() {
+    while (socket_.is_open() && !queued_.empty() &&
+           (int)in_flight_.size() < pipeline_depth_) {
+      Request *req = queued_.front();
+      size_t   len = encode(req);
+      if (len == 0) {
+        queued_.pop_front();
+        complete(req, false);
+        continue;
+      }
+      if (udp_) {
+        ssize_t n =
+          ::send(socket_.fd(), tx_.data(), len, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+          set_want_write(true);  // Gửi lại từ queued_ khi có EPOLLOUT
+          return;
+        }
+        if (n != (ssize_t)len) {
+          fail_all(strerror(errno));
+          return;
+        }
+      } else {
+        tx_len_ += len;
+      }
+      queued_.pop_front();
+      in_flight_.push_back(req);
+    }
+    if (!udp_ && socket_.is_open()) {
+      flush();
+    } else if (udp_ && socket_.is_open()) {
+      set_want_write(false);
+    }
+  }
+
+  // Lấy request ứng với response: theo serial với frame 4E, request gửi
+  // sớm nhất với frame 3E
+  inline Request *take_in_flight(uint16_t serial) {
+    bool by_serial = codec_.config().frame == SlmpFrameType::FRAME_4E;
+    for (auto it = in_flight_.begin(); it != in_flight_.end(); ++it) {
+      if (!by_serial || (*it)->serial == serial) {
+        Request *req = *it;
+        in_flight_.erase(it);
+        return req;
+      }
+    }
+    return nullptr;
+  }
+
+  // Xử lý một response hoàn chỉnh. Trả về false nếu kết nối hỏng.
+  inline bool handle_frame(const uint8_t *buf, size_t len) {
+    SLMP_TRACE_SCOPE("decode", "async");
+    SlmpResponse resp;
+    if (!codec_.decode_response(buf, len, resp)) {
+      fail_all("malformed SLMP response");
+      return false;
+    }
+    Request *req = take_in_flight(resp.serial);
+    if (req == nullptr) {
+      // Response tới sau khi request đã timeout (UDP, frame 4E)
+      std::cerr << "Dropping unexpected SLMP response, serial "
+                << resp.serial << std::endl;
+      return true;
+    }
+    if (resp.end_code != 0) {
+      std::cerr << "PLC returned end code 0x" << std::hex << resp.end_code
+                << std::dec << std::endl;
+      complete(req, false);
+    } else if (!req->write &&
+               !codec_.decode_words(resp, req->read_data, req->num)) {
+      std::cerr << "Malformed SLMP read response" << std::endl;
+      complete(req, false);
+    } else {
+      complete(req, true);
+    }
+    return true;
+  }
+
+  inline void receive() {
+    while (socket_.is_open()) {
+      ssize_t n = ::recv(socket_.fd(),
+                         rx_.data() + rx_len_,
+                         rx_.size() - rx_len_,
+                         MSG_DONTWAIT);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        break;
+      }
+      if (n <= 0) {
+        fail_all(n == 0 ? "connection closed" : strerror(errno));
+        return;
+      }
+
+      if (udp_) {
+        if (!handle_frame(rx_.data(), (size_t)n)) {
+          return;
+        }
+        continue;
+      }
+
+      // TCP: tách các frame hoàn chỉnh, giữ lại phần dở dang
+      rx_len_ += (size_t)n;
+      const size_t header = codec_.response_header_size();
+      size_t       pos    = 0;
+      while (rx_len_ - pos >= header) {
+        size_t   body_len;
+        uint16_t serial;
+        if (!codec_.parse_response_header(rx_.data() + pos, body_len, serial) ||
+            header + body_len > rx_.size()) {
+          fail_all("malformed SLMP response header");
+          return;
+        }
+        if (rx_len_ - pos < header + body_len) {
+          break;
+        }
+        if (!handle_frame(rx_.data() + pos, header + body_len)) {
+          return;
+        }
+        pos += header + body_len;
+      }
+      memmove(rx_.data(), rx_.data() + pos, rx_len_ - pos);
+      rx_len_ -= pos;
+    }
+    pump();
+  }
+
+  inline void on_events(uint32_t events) {
+    if (events & EPOLLIN) {
+      receive();
+    }
+    if ((events & (EPOLLERR | EPOLLHUP)) && socket_.is_open()) {
+      fail_all("socket error");
+      return;
+    }
+    if ((events & EPOLLOUT) && socket_.is_open()) {
+      if (udp_) {
+        pump();
+      } else {
+        flush();
+      }
+    }
+  }
+
+  // TCP: timeout làm hỏng thứ tự stream nên đóng kết nối. UDP với frame 3E
+  // cũng vậy: response tới muộn không có serial và sẽ bị ghép nhầm vào
+  // request kế tiếp. UDP với frame 4E chỉ trả lỗi cho các request quá hạn,
+  // response muộn bị bỏ qua theo serial.
+  inline void check_timeout(Clock::time_point now) {
+    if (in_flight_.empty() || in_flight_.front()->deadline > now) {
+      return;
+    }
+    if (!udp_ || codec_.config().frame == SlmpFrameType::FRAME_3E) {
+      fail_all("request timed out");
+      return;
+    }
+    while (!in_flight_.empty() && in_flight_.front()->deadline <= now) {
+      std::cerr << "SLMP request timed out, serial "
+                << in_flight_.front()->serial << std::endl;
+      complete(in_flight_.front(), false);
+      in_flight_.pop_front();
+    }
+    pump();
+  }
+
+  inline Clock::time_point next_deadline() const {
+    return in_flight_.empty() ? Clock::time_point::max()
+                              : in_flight_.front()->deadline;
+  }
+
+public:
+  // Awaitable của read()/write(). Request nằm luôn trong awaitable (tức
+  // trong frame của coroutine) nên không cấp phát.
+  class Operation {
+  private:
+    AsyncPlcClient &client_;
+    Request         req_;
+
+  public:
+    Operation(AsyncPlcClient &client, const Request &req)
+      : client_(client), req_(req) {
+    }
+
+    bool await_ready() const noexcept {
+      return false;
+    }
+
+    // Trả về false (không tạm dừng) nếu request bị từ chối ngay
+    bool await_suspend(std::coroutine_handle<> handle) {
+      req_.handle = handle;
+      return client_.submit(&req_);
+    }
+
+    bool await_resume() const noexcept {
+      return req_.ok;
+    }
+  };
+
+  AsyncPlcClient(PlcEventLoop   &loop,
+                 std::string     target_ip_addr,
+                 int             target_port,
+                 int             type_protocol,
+                 SlmpFrameConfig frame_config   = {},
+                 int             timeout_ms     = 1000,
+                 int             pipeline_depth = 4)
+    : loop_(loop),
+      target_ip_addr_(std::move(target_ip_addr)),
+      target_port_(target_port),
+      udp_(type_protocol == MELCLI_TYPE_UDPIP),
+      codec_(frame_config),
+      timeout_ms_(timeout_ms),
+      pipeline_depth_(std::clamp(pipeline_depth, 1, kMaxPipelineDepth)) {
+    // Datagram có thể đến sai thứ tự, frame 3E không ghép lại được
+    if (udp_ && frame_config.frame == SlmpFrameType::FRAME_3E) {
+      pipeline_depth_ = 1;
+    }
+    rx_.resize(codec_.max_frame_size(kMaxBatchWords) * 2);
+    loop_.clients_.push_back(this);
+  }
+
+  AsyncPlcClient(const AsyncPlcClient &)            = delete;
+  AsyncPlcClient &operator=(const AsyncPlcClient &) = delete;
+
+  ~AsyncPlcClient() {
+    disconnect();
+    auto &clients = loop_.clients_;
+    clients.erase(std::remove(clients.begin(), clients.end(), this),
+                  clients.end());
+  }
+
+  // Kết nối (blocking, có timeout) rồi chuyển socket sang non-blocking.
+  // Gọi trước run() hoặc từ một task trên loop để kết nối lại.
+  inline bool init_plc() {
+    disconnect();
+    if (!socket_.open(target_ip_addr_, target_port_, udp_, timeout_ms_)) {
+      return false;
+    }
+    int flags = fcntl(socket_.fd(), F_GETFL, 0);
+    if (fcntl(socket_.fd(), F_SETFL, flags | O_NONBLOCK) != 0 ||
+        !loop_.watch(socket_.fd(), this, EPOLLIN)) {
+      socket_.close();
+      return false;
+    }
+    return true;
+  }
+
+  inline bool disconnect() {
+    fail_all(nullptr);
+    return true;
+  }
+
+  inline bool is_connected() const {
+    return socket_.is_open();
+  }
+
+  // Đưa request vào hàng đợi. Trả về false nếu bị từ chối ngay.
+  inline bool submit(Request *req) {
+    if (!socket_.is_open()) {
+      std::cerr << "PLC is not connected" << std::endl;
+      return false;
+    }
+    if (!req->start.valid() || req->num <= 0 || req->num > kMaxBatchWords) {
+      std::cerr << "Invalid async request: " << req->num << " words"
+                << std::endl;
+      return false;
+    }
+    queued_.push_back(req);
+    pump();
+    return true;
+  }
+
+  // co_await client.read("D100", 10, data): đọc num word vào data
+  inline Operation read(const char *addr, int num, uint16_t *data) {
+    Request req;
+    req.start     = parse_device_address(addr);
+    req.num       = num;
+    req.read_data = data;
+    return Operation(*this, req);
+  }
+
+  inline Operation read(const char *addr, uint16_t &data) {
+    return read(addr, 1, &data);
+  }
+
+  // co_await client.write("D100", 10, data): ghi num word từ data. data
+  // phải còn sống tới khi co_await trả về (temporary trong cùng biểu thức
+  // co_await là đủ).
+  inline Operation write(const char *addr, int num, const uint16_t *data) {
+    Request req;
+    req.write      = true;
+    req.start      = parse_device_address(addr);
+    req.num        = num;
+    req.write_data = data;
+    return Operation(*this, req);
+  }
+
+  inline Operation write(const char *addr, const uint16_t &data) {
+    return write(addr, 1, &data);
+  }
+};
+
+inline void PlcEventLoop::check_timeouts(Clock::time_point now) {
+  for (AsyncPlcClient *client : clients_) {
+    client->check_timeout(now);
+  }
+}
+
+// Thời gian epoll_wait tối đa: tới timer hoặc deadline request gần nhất
+inline int PlcEventLoop::wait_timeout_ms(Clock::time_point now) {
+  if (!ready_.empty()) {
+    return 0;
+  }
+  Clock::time_point next = Clock::time_point::max();
+  if (!timers_.empty()) {
+    next = timers_.top().deadline;
+  }
+  for (AsyncPlcClient *client : clients_) {
+    next = std::min(next, client->next_deadline());
+  }
+  if (next == Clock::time_point::max()) {
+    return -1;
+  }
+  if (next <= now) {
+    return 0;
+  }
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(next - now);
+  return (int)((us.count() + 999) / 1000);
+}
+
+inline void PlcEventLoop::dispatch(AsyncPlcClient *client, uint32_t events) {
+  client->on_events(events);
+}
+
+}  // namespace plc_slmp
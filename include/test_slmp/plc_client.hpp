@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -7,7 +8,6 @@
 #include <iostream>
 #include <memory>
 #include <mutex>
-#include <regex>
 #include <string>
 #include <sys/types.h>
 #include <thread>
@@ -16,19 +16,32 @@
 #include <libmelcli/melcli.h>
 #include <libmelcli/melclidef.h>
 
+#include "test_slmp/buffer_pool.hpp"
+#include "test_slmp/device_address.hpp"
+#include "test_slmp/simd_utils.hpp"
+#include "test_slmp/slmp_codec.hpp"
+#include "test_slmp/slmp_transport.hpp"
+#include "test_slmp/trace.hpp"
+
 namespace plc_slmp {
 
-// Enum cho các loại thanh ghi PLC
-enum class RegisterType {
-  D_REGISTER,   // Data register (D0, D100, D1000, ...)
-  X_REGISTER,   // Input register (X0, X1, X10, X100, ...)
-  Y_REGISTER,   // Output register (Y0, Y1, Y10, Y100, ...)
-  M_REGISTER,   // Memory register (M0, M1, M100, ...)
-  B_REGISTER,   // Link register (B0, B1, B10, ...)
-  SD_REGISTER,  // SD register (SD0, SD1, SD10, SD100, ...)
-  UNKNOWN
+// Một đoạn thanh ghi liên tục vừa trong một frame. offset là vị trí (tính
+// theo word) của đoạn này trong buffer của người gọi.
+struct WordChunk {
+  char   addr[kMaxAddressLength] = {};
+  int    num                     = 0;
+  size_t offset                  = 0;
+};
+
+// Backend giao tiếp của PlcClient
+enum class PlcBackend {
+  MELCLI,  // Gọi libmelcli (mặc định)
+  NATIVE   // Codec SLMP trong repo, socket riêng, hỗ trợ pipeline
 };
 
+// Số request tối đa đang chờ phản hồi trong một pipeline
+constexpr int kMaxPipelineDepth = 16;
+
 class PlcClient {
 private:
   melcli_ctx_t *g_ctx_   = NULL;
@@ -44,50 +57,52 @@ private:
   //   Mutex
   std::mutex       mutex_;
 
-  // Regex patterns cho validation
-  std::regex d_register_pattern_{R"(^D\d+$)"};           // D0, D100, D1000, ...
-  std::regex x_register_pattern_{R"(^X[0-9A-Fa-f]+$)"};  // X0, X1, XA, XFF, ...
-  std::regex y_register_pattern_{R"(^Y[0-9A-Fa-f]+$)"};  // Y0, Y1, YA, YFF, ...
-  std::regex m_register_pattern_{R"(^M\d+$)"};           // M0, M1, M100, ...
-  std::regex b_register_pattern_{R"(^B[0-9A-Fa-f]+$)"};  // B0, B1, BA, BFF, ...
-  std::regex sd_register_pattern_{
-    R"(^SD[0-9A-Fa-f]+$)"};  // SD0, SD1, SD10, SD100, ...
-
-  // Validate địa chỉ thanh ghi
+  // Pool buffer cho kết quả đọc và frame của backend native
+  BufferPool       pool_;
+
+  // Backend native
+  PlcBackend backend_    = PlcBackend::MELCLI;
+  SlmpCodec  codec_;
+  SlmpSocket socket_;
+  int        timeout_ms_ = 1000;
+  uint16_t   serial_     = 0;
+
+  // Một request trong pipeline của backend native
+  struct NativeOp {
+    bool            write = false;
+    DeviceAddress   start;
+    int             num        = 0;
+    uint16_t       *read_data  = nullptr;
+    const uint16_t *write_data = nullptr;
+  };
+
+  enum class NativeStatus {
+    OK,
+    PLC_ERROR,  // PLC trả end code lỗi, luồng dữ liệu vẫn đồng bộ
+    BROKEN      // Lỗi socket hoặc frame sai, phải kết nối lại
+  };
+
+  // Validate địa chỉ thanh ghi, không cấp phát
   inline bool validate_register_address(const char *addr) {
-    if (addr == nullptr || strlen(addr) == 0) {
+    if (addr == nullptr || addr[0] == '\0') {
       return false;
     }
 
-    std::string  address(addr);
-    RegisterType type = get_register_type(address);
+    RegisterType type = get_register_type(addr);
 
     if (type == RegisterType::UNKNOWN) {
-      std::cerr << "Invalid register address format: " << address << std::endl;
+      std::cerr << "Invalid register address format: " << addr << std::endl;
       return false;
     }
 
-    // std::cout << "Valid register address: " << address
+    // std::cout << "Valid register address: " << addr
     //           << " (Type: " << static_cast<int>(type) << ")" << std::endl;
     return true;
   }
 
   // Xác định loại thanh ghi
-  inline RegisterType get_register_type(const std::string &addr) {
-    if (std::regex_match(addr, d_register_pattern_)) {
-      return RegisterType::D_REGISTER;
-    } else if (std::regex_match(addr, x_register_pattern_)) {
-      return RegisterType::X_REGISTER;
-    } else if (std::regex_match(addr, y_register_pattern_)) {
-      return RegisterType::Y_REGISTER;
-    } else if (std::regex_match(addr, m_register_pattern_)) {
-      return RegisterType::M_REGISTER;
-    } else if (std::regex_match(addr, b_register_pattern_)) {
-      return RegisterType::B_REGISTER;
-    } else if (std::regex_match(addr, sd_register_pattern_)) {
-      return RegisterType::SD_REGISTER;
-    }
-    return RegisterType::UNKNOWN;
+  inline RegisterType get_register_type(const char *addr) {
+    return classify_register_address(addr);
   }
 
   // Lấy tên loại thanh ghi dưới dạng string
@@ -110,11 +125,249 @@ private:
     }
   }
 
+  // Kiểm tra end code và giải mã dữ liệu đọc của response đã nhận cho op
+  inline NativeStatus native_complete(const NativeOp     &op,
+                                      const SlmpResponse &resp) {
+    if (resp.end_code != 0) {
+      std::cerr << "PLC returned end code 0x" << std::hex << resp.end_code
+                << std::dec << std::endl;
+      return NativeStatus::PLC_ERROR;
+    }
+    if (!op.write && resp.data_len != 0) {
+      SLMP_TRACE_SCOPE_WORDS("decode", "plc", op.num);
+      if (!codec_.decode_words(resp, op.read_data, op.num)) {
+        std::cerr << "Malformed SLMP read response" << std::endl;
+        return NativeStatus::BROKEN;
+      }
+    }
+    return NativeStatus::OK;
+  }
+
+  // Nhận response của op qua TCP. Với binary trên máy little-endian, dữ
+  // liệu đọc được nhận thẳng vào buffer đích, không qua buffer trung gian.
+  inline NativeStatus native_receive(const NativeOp &op,
+                                     uint16_t        serial,
+                                     PooledBuffer   &rx) {
+    SlmpResponse resp;
+    SLMP_TRACE_BEGIN(network_begin);
+    const size_t header = codec_.response_header_size();
+    const size_t ecs    = codec_.end_code_size();
+    size_t       body_len;
+    if (!socket_.recv_exact(rx.data(), header)) {
+      return NativeStatus::BROKEN;
+    }
+    if (!codec_.parse_response_header(rx.data(), body_len, resp.serial) ||
+        header + body_len > rx.size()) {
+      std::cerr << "Malformed SLMP response header" << std::endl;
+      return NativeStatus::BROKEN;
+    }
+    uint8_t *body = rx.data() + header;
+    if (!socket_.recv_exact(body, ecs) ||
+        !codec_.parse_end_code(body, resp.end_code)) {
+      return NativeStatus::BROKEN;
+    }
+    resp.data     = body + ecs;
+    resp.data_len = body_len - ecs;
+
+    bool direct = !TEST_SLMP_BIG_ENDIAN && resp.end_code == 0 && !op.write &&
+                  codec_.config().encoding == SlmpEncoding::BINARY &&
+                  resp.data_len == (size_t)op.num * 2;
+    if (direct) {
+      if (!socket_.recv_exact((uint8_t *)op.read_data, resp.data_len)) {
+        return NativeStatus::BROKEN;
+      }
+    } else if (!socket_.recv_exact(body + ecs, resp.data_len)) {
+      return NativeStatus::BROKEN;
+    }
+    if (direct) {
+      resp.data_len = 0;
+    }
+    SLMP_TRACE_END(network_begin, "network", "plc");
+
+    // Trên TCP response đến đúng thứ tự, serial sai nghĩa là luồng dữ liệu
+    // đã lệch
+    if (codec_.config().frame == SlmpFrameType::FRAME_4E &&
+        resp.serial != serial) {
+      std::cerr << "SLMP serial mismatch: expected " << serial << ", got "
+                << resp.serial << std::endl;
+      return NativeStatus::BROKEN;
+    }
+    return native_complete(op, resp);
+  }
+
+  // Nhận datagram qua UDP cho tới khi op thứ done của pipeline có response
+  // hoặc hết timeout_ms_. Với frame 4E, datagram được ghép với request theo
+  // serial: response của một request khác đang chờ (đến sai thứ tự) được
+  // xử lý luôn và đánh dấu trong received (bit i ứng với op done + i), còn
+  // datagram hỏng, trùng hoặc của request đã quá hạn bị bỏ qua. Frame 3E
+  // không có serial và chỉ chạy với depth 1, mọi datagram hợp lệ là
+  // response của op done. ok thành false nếu PLC trả end code lỗi. Trả về
+  // false nếu hết hạn hoặc phải kết nối lại.
+  template <typename OpAt>
+  inline bool native_receive_datagrams(size_t        done,
+                                       size_t        sent,
+                                       uint16_t      first_serial,
+                                       uint32_t     &received,
+                                       bool         &ok,
+                                       OpAt         &op_at,
+                                       PooledBuffer &rx) {
+    const bool serials  = codec_.config().frame == SlmpFrameType::FRAME_4E;
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(timeout_ms_);
+    while ((received & 1) == 0) {
+      SlmpResponse resp;
+      SLMP_TRACE_BEGIN(network_begin);
+      long n = socket_.recv_datagram(rx.data(), rx.size(), deadline);
+      if (n < 0) {
+        return false;
+      }
+      SLMP_TRACE_END(network_begin, "network", "plc");
+      if (!codec_.decode_response(rx.data(), (size_t)n, resp)) {
+        std::cerr << "Discarding malformed SLMP datagram" << std::endl;
+        continue;
+      }
+
+      size_t index = done;
+      if (serials) {
+        index = (uint16_t)(resp.serial - first_serial);
+        if (index < done || index >= sent ||
+            ((received >> (index - done)) & 1) != 0) {
+          std::cerr << "Discarding SLMP response with unexpected serial "
+                    << resp.serial << std::endl;
+          continue;
+        }
+      }
+      NativeStatus status = native_complete(op_at(index), resp);
+      if (status == NativeStatus::BROKEN) {
+        return false;
+      }
+      ok = ok && status == NativeStatus::OK;
+      received |= 1u << (index - done);
+    }
+    return true;
+  }
+
+  // Gửi count request của backend native, tối đa depth request chưa có
+  // phản hồi. op_at(i) trả về NativeOp thứ i. mutex_ phải đang được giữ.
+  template <typename OpAt>
+  inline bool native_pipeline(size_t count, int depth, OpAt op_at) {
+    if (!socket_.is_open()) {
+      std::cerr << "PLC is not connected" << std::endl;
+      return false;
+    }
+    PooledBuffer tx = pool_.acquire();
+    PooledBuffer rx = pool_.acquire();
+    if (!tx || !rx) {
+      return false;
+    }
+    depth = std::max(1, std::min(depth, kMaxPipelineDepth));
+    // Frame 3E không có serial, qua UDP datagram có thể đến sai thứ tự nên
+    // không ghép được response với request: chỉ gửi từng frame một
+    if (socket_.udp() && codec_.config().frame == SlmpFrameType::FRAME_3E) {
+      depth = 1;
+    }
+
+    const uint16_t first_serial = serial_;
+    bool           ok           = true;
+    size_t         sent         = 0;
+    uint32_t       received     = 0;  // Xem native_receive_datagrams
+    for (size_t done = 0; done < count; done++) {
+      while (sent < count && sent - done < (size_t)depth) {
+        const NativeOp op     = op_at(sent);
+        const uint16_t serial = (uint16_t)(first_serial + sent);
+        SLMP_TRACE_BEGIN(encode_begin);
+        size_t len =
+          op.write ? codec_.encode_write(
+                       tx.data(), tx.size(), op.start, op.num, op.write_data,
+                       serial)
+                   : codec_.encode_read(
+                       tx.data(), tx.size(), op.start, op.num, serial);
+        SLMP_TRACE_END(encode_begin, "encode", "plc");
+        if (len == 0) {
+          std::cerr << "Failed to encode SLMP request of " << op.num
+                    << " words" << std::endl;
+          ok    = false;
+          count = sent;
+          break;
+        }
+        SLMP_TRACE_BEGIN(send_begin);
+        if (!socket_.send_all(tx.data(), len)) {
+          socket_.close();
+          return false;
+        }
+        SLMP_TRACE_END(send_begin, "send", "plc");
+        sent++;
+      }
+      if (done >= count) {
+        break;
+      }
+
+      if (socket_.udp()) {
+        if (!native_receive_datagrams(
+              done, sent, first_serial, received, ok, op_at, rx)) {
+          socket_.close();
+          return false;
+        }
+        received >>= 1;
+        continue;
+      }
+      NativeStatus status =
+        native_receive(op_at(done), (uint16_t)(first_serial + done), rx);
+      if (status == NativeStatus::BROKEN) {
+        socket_.close();
+        return false;
+      }
+      ok = ok && status == NativeStatus::OK;
+    }
+    serial_ = (uint16_t)(first_serial + sent);
+    return ok;
+  }
+
+  // Đọc num word từ addr vào data. mutex_ phải đang được giữ.
+  inline bool transfer_read(const char *addr, int num, uint16_t *data) {
+    if (backend_ == PlcBackend::NATIVE) {
+      NativeOp op;
+      op.start     = parse_device_address(addr);
+      op.num       = num;
+      op.read_data = data;
+      return native_pipeline(1, 1, [&](size_t) { return op; });
+    }
+
+    SLMP_TRACE_SCOPE_WORDS("melcli_batch_read", "plc", num);
+    uint16_t *rd_words;
+    if (melcli_batch_read(
+          g_ctx_, NULL, addr, num, (char **)(&rd_words), NULL) != 0) {
+      return false;
+    }
+    memcpy(data, rd_words, num * sizeof(uint16_t));
+    melcli_free(rd_words);
+    return true;
+  }
+
+  // Ghi num word từ data vào addr. mutex_ phải đang được giữ.
+  inline bool transfer_write(const char *addr, int num, const uint16_t *data) {
+    if (backend_ == PlcBackend::NATIVE) {
+      NativeOp op;
+      op.write      = true;
+      op.start      = parse_device_address(addr);
+      op.num        = num;
+      op.write_data = data;
+      return native_pipeline(1, 1, [&](size_t) { return op; });
+    }
+
+    SLMP_TRACE_SCOPE_WORDS("melcli_batch_write", "plc", num);
+    return melcli_batch_write(g_ctx_, NULL, addr, num, (char *)(data)) == 0;
+  }
+
 public:
-  PlcClient(std::string target_ip_addr, int target_port, int type_protocol)
+  PlcClient(std::string target_ip_addr,
+            int         target_port,
+            int         type_protocol,
+            size_t      pool_slabs = kDefaultSlabCount)
     : ctxtype_(type_protocol),
       target_ip_addr_(target_ip_addr),
-      target_port_(target_port) {
+      target_port_(target_port),
+      pool_(pool_slabs) {
     std::cout << "PLC Client has been created." << std::endl;
     std::cout << "PLC IP: " << target_ip_addr_ << std::endl;
     std::cout << "PLC Port: " << target_port_ << std::endl;
@@ -133,7 +386,28 @@ public:
     }
   }
 
+  // Chọn backend, phải gọi trước init_plc(). Backend native dùng codec SLMP
+  // trong repo với frame (3E/4E, binary/ASCII) theo frame_config.
+  inline void set_backend(PlcBackend      backend,
+                          SlmpFrameConfig frame_config = {},
+                          int             timeout_ms   = 1000) {
+    backend_    = backend;
+    codec_      = SlmpCodec(frame_config);
+    timeout_ms_ = timeout_ms;
+  }
+
+  inline PlcBackend backend() const {
+    return backend_;
+  }
+
   inline bool init_plc() {
+    if (backend_ == PlcBackend::NATIVE) {
+      return socket_.open(target_ip_addr_,
+                          target_port_,
+                          ctxtype_ == MELCLI_TYPE_UDPIP,
+                          timeout_ms_);
+    }
+
     try {
       if (g_ctx_ != NULL) {
         melcli_disconnect(g_ctx_);
@@ -161,28 +435,29 @@ public:
     return true;
   }
   inline bool disconnect() {
+    socket_.close();
     if (g_ctx_ != NULL) {
       melcli_disconnect(g_ctx_);
       melcli_free_context(g_ctx_);
+      g_ctx_ = NULL;
     }
     return true;
   }
 
   inline bool read_batch_d_register(const char *addr, uint16_t &data) {
+    SLMP_TRACE_SCOPE_WORDS("read", "plc", 1);
     // Validate địa chỉ thanh ghi trước khi đọc
     if (!validate_register_address(addr)) {
       return false;
     }
 
+    SLMP_TRACE_BEGIN(lock_begin);
     std::lock_guard<std::mutex> lock(mutex_);
-    uint16_t                   *rd_words;
-    if (melcli_batch_read(g_ctx_, NULL, addr, 1, (char **)(&rd_words), NULL) !=
-        0) {
+    SLMP_TRACE_END(lock_begin, "lock_wait", "plc");
+    if (!transfer_read(addr, 1, &data)) {
       std::cerr << "Failed to batch read from address: " << addr << std::endl;
       return false;
     }
-    data = rd_words[0];
-    melcli_free(rd_words);
 
     // std::cout << "Successfully read from " << addr << ": " << data <<
     // std::endl;
@@ -192,39 +467,80 @@ public:
   inline bool read_batch_d_registers(const char            *addr,
                                      int                    num,
                                      std::vector<uint16_t> &data) {
+    SLMP_TRACE_SCOPE_WORDS("read", "plc", num);
     // Validate địa chỉ thanh ghi trước khi đọc
     if (!validate_register_address(addr)) {
       return false;
     }
+    if (num <= 0 || num > kMaxBatchWords) {
+      std::cerr << "Invalid batch read length: " << num << std::endl;
+      return false;
+    }
 
+    SLMP_TRACE_BEGIN(lock_begin);
     std::lock_guard<std::mutex> lock(mutex_);
-    uint16_t                   *rd_words;
-    if (melcli_batch_read(
-          g_ctx_, NULL, addr, num, (char **)(&rd_words), NULL) != 0) {
+    SLMP_TRACE_END(lock_begin, "lock_wait", "plc");
+    data.resize(num);
+    if (!transfer_read(addr, num, data.data())) {
       std::cerr << "Failed to batch read " << num
                 << " registers from address: " << addr << std::endl;
       return false;
     }
 
-    data.resize(num);
-    for (size_t i = 0; i < num; i++) {
-      data[i] = rd_words[i];
-    }
-    melcli_free(rd_words);
-
     // std::cout << "Successfully read " << num << " registers from " << addr
     //           << std::endl;
     return true;
   }
 
+  // Đọc num thanh ghi vào một slab lấy từ pool của client, slab tự trả về
+  // pool khi data bị hủy. Dùng cho vòng quét tần số cao để tránh cấp phát
+  // vector cho mỗi lần đọc.
+  inline bool read_batch_d_registers(const char   *addr,
+                                     int           num,
+                                     PooledBuffer &data) {
+    SLMP_TRACE_SCOPE_WORDS("read", "plc", num);
+    // Validate địa chỉ thanh ghi trước khi đọc
+    if (!validate_register_address(addr)) {
+      return false;
+    }
+    if (num <= 0 || num > kMaxBatchWords) {
+      std::cerr << "Invalid batch read length: " << num << std::endl;
+      return false;
+    }
+
+    // Dùng lại slab cũ nếu đủ lớn, ngược lại trả nó về trước khi lấy slab
+    // mới để một vòng quét không giữ hai slab cùng lúc
+    if (data.size() < num * sizeof(uint16_t)) {
+      data.release();
+      data = pool_.acquire(num * sizeof(uint16_t));
+    }
+    if (!data) {
+      return false;
+    }
+
+    SLMP_TRACE_BEGIN(lock_begin);
+    std::lock_guard<std::mutex> lock(mutex_);
+    SLMP_TRACE_END(lock_begin, "lock_wait", "plc");
+    if (!transfer_read(addr, num, data.words())) {
+      std::cerr << "Failed to batch read " << num
+                << " registers from address: " << addr << std::endl;
+      data.release();
+      return false;
+    }
+    return true;
+  }
+
   inline bool write_batch_d_register(const char *addr, uint16_t data) {
+    SLMP_TRACE_SCOPE_WORDS("write", "plc", 1);
     // Validate địa chỉ thanh ghi trước khi ghi
     if (!validate_register_address(addr)) {
       return false;
     }
 
+    SLMP_TRACE_BEGIN(lock_begin);
     std::lock_guard<std::mutex> lock(mutex_);
-    if (melcli_batch_write(g_ctx_, NULL, addr, 1, (char *)(&data)) != 0) {
+    SLMP_TRACE_END(lock_begin, "lock_wait", "plc");
+    if (!transfer_write(addr, 1, &data)) {
       std::cerr << "Failed to batch write to address: " << addr << std::endl;
       return false;
     }
@@ -237,23 +553,27 @@ public:
   inline bool write_batch_d_registers(const char                  *addr,
                                       int                          num,
                                       const std::vector<uint16_t> &data) {
+    SLMP_TRACE_SCOPE_WORDS("write", "plc", num);
     // Validate địa chỉ thanh ghi trước khi ghi
     if (!validate_register_address(addr)) {
       return false;
     }
 
-    if (data.size() < num) {
+    if (num <= 0 || num > kMaxBatchWords) {
+      std::cerr << "Invalid batch write length: " << num << std::endl;
+      return false;
+    }
+    if (data.size() < (size_t)num) {
       std::cerr << "Data vector size (" << data.size()
                 << ") is smaller than requested write count (" << num << ")"
                 << std::endl;
       return false;
     }
 
+    SLMP_TRACE_BEGIN(lock_begin);
     std::lock_guard<std::mutex> lock(mutex_);
-    std::vector<uint16_t>       write_data(data.begin(), data.begin() + num);
-
-    if (melcli_batch_write(
-          g_ctx_, NULL, addr, num, (char *)(write_data.data())) != 0) {
+    SLMP_TRACE_END(lock_begin, "lock_wait", "plc");
+    if (!transfer_write(addr, num, data.data())) {
       std::cerr << "Failed to batch write " << num
                 << " registers to address: " << addr << std::endl;
       return false;
@@ -264,6 +584,167 @@ public:
     return true;
   }
 
+  // Đọc các chunk trong cùng một lần giữ mutex_, mỗi chunk được giải mã
+  // thẳng vào data + chunk.offset. Mỗi chunk phải có num <= kMaxBatchWords;
+  // việc chia chunk do TransferEngine đảm nhận. Với backend native, tối đa
+  // pipeline_depth request được gửi trước khi chờ phản hồi; libmelcli luôn
+  // chạy tuần tự.
+  inline bool read_chunks(const WordChunk *chunks,
+                          size_t           count,
+                          uint16_t        *data,
+                          int              pipeline_depth = 1) {
+    SLMP_TRACE_SCOPE("read_chunks", "plc");
+    SLMP_TRACE_BEGIN(lock_begin);
+    std::lock_guard<std::mutex> lock(mutex_);
+    SLMP_TRACE_END(lock_begin, "lock_wait", "plc");
+    if (backend_ == PlcBackend::NATIVE) {
+      if (!native_pipeline(count, pipeline_depth, [&](size_t i) {
+            NativeOp op;
+            op.start     = parse_device_address(chunks[i].addr);
+            op.num       = chunks[i].num;
+            op.read_data = data + chunks[i].offset;
+            return op;
+          })) {
+        std::cerr << "Failed to read " << count << " chunks from address: "
+                  << (count > 0 ? chunks[0].addr : "") << std::endl;
+        return false;
+      }
+      return true;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      const WordChunk &chunk = chunks[i];
+      if (!transfer_read(chunk.addr, chunk.num, data + chunk.offset)) {
+        std::cerr << "Failed to batch read " << chunk.num
+                  << " registers from address: " << chunk.addr << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Ghi các chunk trong cùng một lần giữ mutex_, dữ liệu của mỗi chunk lấy
+  // từ data + chunk.offset.
+  inline bool write_chunks(const WordChunk *chunks,
+                           size_t           count,
+                           const uint16_t  *data,
+                           int              pipeline_depth = 1) {
+    SLMP_TRACE_SCOPE("write_chunks", "plc");
+    SLMP_TRACE_BEGIN(lock_begin);
+    std::lock_guard<std::mutex> lock(mutex_);
+    SLMP_TRACE_END(lock_begin, "lock_wait", "plc");
+    if (backend_ == PlcBackend::NATIVE) {
+      if (!native_pipeline(count, pipeline_depth, [&](size_t i) {
+            NativeOp op;
+            op.write      = true;
+            op.start      = parse_device_address(chunks[i].addr);
+            op.num        = chunks[i].num;
+            op.write_data = data + chunks[i].offset;
+            return op;
+          })) {
+        std::cerr << "Failed to write " << count << " chunks to address: "
+                  << (count > 0 ? chunks[0].addr : "") << std::endl;
+        return false;
+      }
+      return true;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      const WordChunk &chunk = chunks[i];
+      if (!transfer_write(chunk.addr, chunk.num, data + chunk.offset)) {
+        std::cerr << "Failed to batch write " << chunk.num
+                  << " registers to address: " << chunk.addr << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Ghi num thanh ghi rồi đọc lại ngay trong cùng một lần giữ mutex_, không
+  // có request nào của thread khác chen vào giữa hai frame. Với backend
+  // native, frame ghi và frame đọc lại được gửi liền nhau trước khi chờ
+  // phản hồi, tổng thời gian gần bằng một round trip. mismatch_offsets
+  // chứa offset (tính từ addr) của các thanh ghi đọc lại khác giá trị đã ghi.
+  // Trả về false nếu ghi/đọc lỗi hoặc có thanh ghi không khớp.
+  inline bool write_and_verify(const char                  *addr,
+                               int                          num,
+                               const std::vector<uint16_t> &data,
+                               std::vector<int>            &mismatch_offsets) {
+    SLMP_TRACE_SCOPE_WORDS("write_and_verify", "plc", num);
+    mismatch_offsets.clear();
+
+    // Validate địa chỉ thanh ghi trước khi ghi
+    if (!validate_register_address(addr)) {
+      return false;
+    }
+
+    if (num <= 0 || num > kMaxBatchWords) {
+      std::cerr << "Invalid batch write length: " << num << std::endl;
+      return false;
+    }
+    if (data.size() < (size_t)num) {
+      std::cerr << "Data vector size (" << data.size()
+                << ") is smaller than requested write count (" << num << ")"
+                << std::endl;
+      return false;
+    }
+
+    SLMP_TRACE_BEGIN(lock_begin);
+    std::lock_guard<std::mutex> lock(mutex_);
+    SLMP_TRACE_END(lock_begin, "lock_wait", "plc");
+    if (backend_ == PlcBackend::NATIVE) {
+      PooledBuffer read_back = pool_.acquire(num * sizeof(uint16_t));
+      NativeOp     ops[2];
+      ops[0].write      = true;
+      ops[0].start      = parse_device_address(addr);
+      ops[0].num        = num;
+      ops[0].write_data = data.data();
+      ops[1].start      = ops[0].start;
+      ops[1].num        = num;
+      ops[1].read_data  = read_back.words();
+      if (!read_back || !native_pipeline(2, 2, [&](size_t i) {
+            return ops[i];
+          })) {
+        std::cerr << "Failed to write and read back " << num
+                  << " registers at address: " << addr << std::endl;
+        return false;
+      }
+      find_word_mismatches(
+        data.data(), read_back.words(), num, mismatch_offsets);
+      return mismatch_offsets.empty();
+    }
+
+    if (melcli_batch_write(g_ctx_, NULL, addr, num, (char *)(data.data())) !=
+        0) {
+      std::cerr << "Failed to batch write " << num
+                << " registers to address: " << addr << std::endl;
+      return false;
+    }
+
+    uint16_t *rd_words;
+    if (melcli_batch_read(
+          g_ctx_, NULL, addr, num, (char **)(&rd_words), NULL) != 0) {
+      std::cerr << "Failed to read back " << num
+                << " registers from address: " << addr << std::endl;
+      return false;
+    }
+
+    find_word_mismatches(data.data(), rd_words, num, mismatch_offsets);
+    melcli_free(rd_words);
+
+    return mismatch_offsets.empty();
+  }
+
+  // Lấy một buffer từ pool của client (frame, slab kết quả, ...)
+  inline PooledBuffer acquire_buffer(size_t bytes = 0) {
+    return pool_.acquire(bytes);
+  }
+
+  // Thống kê pool, dùng high_water và fallbacks để chọn pool_slabs
+  inline BufferPoolStats pool_stats() {
+    return pool_.stats();
+  }
+
   // Thêm method public để validate address từ bên ngoài
   inline bool is_valid_register_address(const char *addr) {
     return validate_register_address(addr);
@@ -273,7 +754,7 @@ public:
   inline RegisterType get_address_type(const char *addr) {
     if (addr == nullptr)
       return RegisterType::UNKNOWN;
-    return get_register_type(std::string(addr));
+    return get_register_type(addr);
   }
 
   // Thêm method public để lấy tên loại thanh ghi
@@ -0,0 +1,470 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test_slmp/device_address.hpp"
+#include "test_slmp/plc_client.hpp"
+#include "test_slmp/trace.hpp"
+#include "test_slmp/transfer_engine.hpp"
+
+namespace plc_slmp {
+
+// Tầng làm mới của một segment
+enum class MirrorTier {
+  HOT,  // Làm mới mỗi hot_period
+  COLD  // Làm mới mỗi cold_period
+};
+
+// Tham số của RegionMirror
+struct MirrorParams {
+  int                       segment_words = 64;  // Kích thước segment (word)
+  std::chrono::milliseconds hot_period{50};
+  std::chrono::milliseconds cold_period{1000};
+  // Segment được đọc từ bản sao >= promote_reads lần trong access_window
+  // được coi là đang dùng và lên tầng nóng
+  int                       promote_reads = 10;
+  std::chrono::milliseconds access_window{1000};
+  // Segment nóng không đổi và ít được đọc trong demote_after thì xuống lạnh
+  std::chrono::milliseconds demote_after{3000};
+};
+
+// Thống kê của RegionMirror
+struct MirrorStats {
+  uint64_t cycles        = 0;  // Số lần refresh_once có đọc PLC
+  uint64_t segment_reads = 0;  // Số lần đọc segment từ PLC
+  uint64_t words_read    = 0;
+  uint64_t changes       = 0;  // Số lần một segment đọc về khác bản sao
+  uint64_t promotions    = 0;
+  uint64_t demotions     = 0;
+  uint64_t errors        = 0;  // Số lần refresh_once đọc lỗi
+  size_t   segments      = 0;
+  size_t   hot_segments  = 0;
+};
+
+// Bản sao cục bộ của một vùng thanh ghi lớn (ví dụ D0-D12000). Vùng được chia
+// thành segment; segment nóng được đọc lại mỗi hot_period, segment lạnh mỗi
+// cold_period. Segment lạnh lên tầng nóng khi lần làm mới thấy dữ liệu đổi
+// hoặc khi được đọc nhiều, và xuống lại khi yên trong demote_after. Các
+// segment đến hạn cùng lúc được đọc trong một lần read_ranges nên segment
+// liền nhau được gộp frame. Người dùng chỉ đọc bản sao, không chờ PLC.
+class RegionMirror {
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Segment {
+    char       addr[kMaxAddressLength] = {};
+    size_t     offset                  = 0;
+    int        num                     = 0;
+    MirrorTier tier                    = MirrorTier::COLD;
+    bool       loaded                  = false;
+    uint64_t   sequence                = 0;  // Tăng mỗi lần dữ liệu đổi
+    uint64_t   write_generation        = 0;  // Tăng mỗi lần write()
+
+    // Chỉ thread làm mới dùng
+    Clock::time_point next_refresh;
+    Clock::time_point last_active;  // Lần cuối dữ liệu đổi hoặc đọc nhiều
+    Clock::time_point window_start;
+
+    std::atomic<uint32_t> reads{0};  // Số lần đọc bản sao trong cửa sổ
+  };
+
+  TransferEngine             engine_;
+  MirrorParams               params_;
+  std::string                addr_;
+  int                        num_ = 0;
+  DeviceAddress              base_;
+  std::unique_ptr<Segment[]> segments_;
+  size_t                     segment_count_ = 0;
+  Clock::time_point          epoch_;  // Gốc của lưới tick hot_period
+
+  // Bản sao, trạng thái segment đọc từ thread khác và thống kê
+  mutable std::shared_mutex data_mutex_;
+  std::vector<uint16_t>     data_;
+  MirrorStats               stats_;
+
+  // Chỉ một lần làm mới tại một thời điểm
+  std::mutex             refresh_mutex_;
+  std::vector<uint16_t>  staging_;
+  std::vector<RangeRead> ranges_;
+  std::vector<size_t>    due_;
+  std::vector<uint64_t>  due_generation_;  // write_generation lúc chọn
+
+  std::thread             worker_;
+  std::atomic<bool>       running_{false};
+  std::mutex              wake_mutex_;
+  std::condition_variable wake_cv_;
+
+  inline std::chrono::milliseconds period(MirrorTier tier) const {
+    return tier == MirrorTier::HOT ? params_.hot_period : params_.cold_period;
+  }
+
+  // Tìm vị trí (word) của addr trong bản sao, kiểm tra [addr, addr + num)
+  // nằm trong vùng
+  inline bool locate(const char *addr, int num, size_t &offset) const {
+    const DeviceAddress start = parse_device_address(addr);
+    const uint32_t      step  = points_per_word(base_.type);
+    if (!start.valid() || start.type != base_.type ||
+        start.number < base_.number ||
+        (start.number - base_.number) % step != 0 || num <= 0) {
+      std::cerr << "Address " << (addr != nullptr ? addr : "(null)")
+                << " is not in mirror " << addr_ << std::endl;
+      return false;
+    }
+    offset = (start.number - base_.number) / step;
+    if (offset + (size_t)num > (size_t)num_) {
+      std::cerr << "Access of " << num << " words from " << addr
+                << " exceeds mirror " << addr_ << " x " << num_ << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  // Tick của lưới hot_period ngay trước t. Mọi lịch làm mới nằm trên lưới
+  // này nên segment lạnh luôn được đọc cùng lần với segment nóng.
+  inline Clock::time_point tick_of(Clock::time_point t) const {
+    return epoch_ + ((t - epoch_) / params_.hot_period) * params_.hot_period;
+  }
+
+  // Cập nhật bản sao và tầng của segment i sau một lần đọc thành công ở
+  // tick, hoàn tất lúc now. generation là write_generation của segment
+  // trước khi đọc. data_mutex_ phải đang được giữ (ghi).
+  inline void commit_segment(size_t            i,
+                             uint64_t          generation,
+                             Clock::time_point tick,
+                             Clock::time_point now) {
+    Segment     &seg   = segments_[i];
+    const size_t bytes = (size_t)seg.num * sizeof(uint16_t);
+    stats_.segment_reads++;
+    stats_.words_read += (uint64_t)seg.num;
+    if (seg.write_generation != generation) {
+      // write() đã cập nhật segment trong lúc đọc, dữ liệu đọc về có thể cũ
+      // hơn bản sao: bỏ kết quả này và đọc lại ở tick sau
+      seg.next_refresh = tick + params_.hot_period;
+      return;
+    }
+    const bool   first = !seg.loaded;
+    const bool   changed =
+      !first &&
+      memcmp(data_.data() + seg.offset, staging_.data() + seg.offset, bytes) !=
+        0;
+    if (first || changed) {
+      memcpy(data_.data() + seg.offset, staging_.data() + seg.offset, bytes);
+      seg.loaded = true;
+      seg.sequence++;
+    }
+
+    bool active = changed;
+    if (changed) {
+      stats_.changes++;
+    }
+    const auto window = now - seg.window_start;
+    if (window >= params_.access_window) {
+      // Quy số lần đọc về một access_window để so với promote_reads
+      const uint32_t reads = seg.reads.exchange(0, std::memory_order_relaxed);
+      const double   rate  = reads * (double)params_.access_window.count() /
+                          std::chrono::duration<double, std::milli>(window)
+                            .count();
+      active = active || rate >= params_.promote_reads;
+      seg.window_start = now;
+    }
+    if (active) {
+      seg.last_active = now;
+    }
+
+    if (first) {
+      // Lần đọc đầu: dàn các segment lạnh đều trên các tick của cold_period
+      // để không dồn cả vùng vào cùng một tick
+      const int64_t slots = params_.cold_period / params_.hot_period;
+      seg.next_refresh =
+        tick + params_.hot_period *
+                 (1 + (int64_t)i * slots / (int64_t)segment_count_);
+      return;
+    }
+    if (seg.tier == MirrorTier::COLD && active) {
+      seg.tier = MirrorTier::HOT;
+      stats_.promotions++;
+    } else if (seg.tier == MirrorTier::HOT &&
+               now - seg.last_active >= params_.demote_after) {
+      seg.tier = MirrorTier::COLD;
+      stats_.demotions++;
+    }
+    seg.next_refresh = tick + period(seg.tier);
+  }
+
+  inline void loop() {
+    while (running_) {
+      refresh_once();
+      const Clock::time_point      next = next_due();
+      std::unique_lock<std::mutex> lock(wake_mutex_);
+      wake_cv_.wait_until(lock, next, [this]() { return !running_; });
+    }
+  }
+
+  inline Clock::time_point next_due() {
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
+    Clock::time_point next = Clock::now() + params_.cold_period;
+    for (size_t i = 0; i < segment_count_; i++) {
+      next = std::min(next, segments_[i].next_refresh);
+    }
+    return next;
+  }
+
+protected:
+  // Như refresh_once() nhưng gọi after_read() sau khi đọc PLC xong và trước
+  // khi cập nhật bản sao
+  template <typename Fn>
+  inline bool refresh_once(Fn after_read) {
+    std::lock_guard<std::mutex> refresh_lock(refresh_mutex_);
+    const auto                  now  = Clock::now();
+    const auto                  tick = tick_of(now);
+    ranges_.clear();
+    due_.clear();
+    due_generation_.clear();
+    size_t words = 0;
+    {
+      std::shared_lock<std::shared_mutex> lock(data_mutex_);
+      for (size_t i = 0; i < segment_count_; i++) {
+        Segment &seg = segments_[i];
+        if (seg.next_refresh > now) {
+          continue;
+        }
+        RangeRead range;
+        range.addr = seg.addr;
+        range.num  = seg.num;
+        range.data = staging_.data() + seg.offset;
+        ranges_.push_back(range);
+        due_.push_back(i);
+        due_generation_.push_back(seg.write_generation);
+        words += (size_t)seg.num;
+      }
+    }
+    if (due_.empty()) {
+      return true;
+    }
+
+    SLMP_TRACE_SCOPE_WORDS("mirror_refresh", "mirror", words);
+    const bool ok   = engine_.read_ranges(ranges_.data(), ranges_.size());
+    const auto done = Clock::now();
+    after_read();
+
+    std::unique_lock<std::shared_mutex> lock(data_mutex_);
+    stats_.cycles++;
+    if (!ok) {
+      stats_.errors++;
+      for (size_t i : due_) {
+        segments_[i].next_refresh = tick + params_.hot_period;
+      }
+      return false;
+    }
+    for (size_t k = 0; k < due_.size(); k++) {
+      commit_segment(due_[k], due_generation_[k], tick, done);
+    }
+    return true;
+  }
+
+public:
+  RegionMirror(PlcClient     &plc,
+               std::string    addr,
+               int            num,
+               MirrorParams   params   = {},
+               TransferParams transfer = {})
+    : engine_(plc, transfer), params_(params), addr_(std::move(addr)),
+      num_(num) {
+  }
+
+  RegionMirror(const RegionMirror &)            = delete;
+  RegionMirror &operator=(const RegionMirror &) = delete;
+
+  ~RegionMirror() {
+    stop();
+  }
+
+  // Kiểm tra vùng và chia segment. Bản sao chưa có dữ liệu cho tới lần
+  // refresh_once đầu tiên.
+  inline bool init() {
+    base_ = parse_device_address(addr_.c_str());
+    if (!base_.valid() || num_ <= 0 ||
+        base_.number + (uint64_t)num_ * points_per_word(base_.type) - 1 >
+          kMaxDeviceNumber) {
+      std::cerr << "Invalid mirror region: " << addr_ << " x " << num_
+                << std::endl;
+      return false;
+    }
+    if (params_.segment_words <= 0 || params_.hot_period.count() <= 0 ||
+        params_.cold_period < params_.hot_period ||
+        params_.access_window.count() <= 0) {
+      std::cerr << "Invalid mirror parameters" << std::endl;
+      return false;
+    }
+
+    std::lock_guard<std::mutex>         refresh_lock(refresh_mutex_);
+    std::unique_lock<std::shared_mutex> lock(data_mutex_);
+    const int      words = params_.segment_words;
+    const uint32_t step  = points_per_word(base_.type);
+    const auto     now   = Clock::now();
+    epoch_               = now;
+    segment_count_       = (size_t)((num_ + words - 1) / words);
+    segments_.reset(new Segment[segment_count_]);
+    for (size_t i = 0; i < segment_count_; i++) {
+      Segment      &seg   = segments_[i];
+      DeviceAddress start = base_;
+      start.number += (uint32_t)(i * words) * step;
+      format_device_address(start, seg.addr, sizeof(seg.addr));
+      seg.offset       = i * (size_t)words;
+      seg.num          = std::min(words, num_ - (int)seg.offset);
+      seg.last_active  = now;
+      seg.window_start = now;
+    }
+    data_.assign((size_t)num_, 0);
+    staging_.assign((size_t)num_, 0);
+    stats_          = MirrorStats();
+    stats_.segments = segment_count_;
+    return true;
+  }
+
+  // Đọc từ PLC mọi segment đã đến hạn. Trả về false nếu lần đọc lỗi; bản sao
+  // giữ dữ liệu cũ và các segment được thử lại sau hot_period.
+  inline bool refresh_once() {
+    return refresh_once([]() {});
+  }
+
+  // Đọc num word từ bản sao. Trả về false nếu vùng nằm ngoài mirror hoặc
+  // chưa được đọc từ PLC lần nào.
+  inline bool read(const char *addr, int num, uint16_t *data) {
+    size_t offset = 0;
+    if (!locate(addr, num, offset)) {
+      return false;
+    }
+    const size_t words = (size_t)params_.segment_words;
+    const size_t first = offset / words;
+    const size_t last  = (offset + (size_t)num - 1) / words;
+
+    std::shared_lock<std::shared_mutex> lock(data_mutex_);
+    for (size_t i = first; i <= last; i++) {
+      if (!segments_[i].loaded) {
+        std::cerr << "Mirror segment " << segments_[i].addr
+                  << " has not been read yet" << std::endl;
+        return false;
+      }
+      segments_[i].reads.fetch_add(1, std::memory_order_relaxed);
+    }
+    memcpy(data, data_.data() + offset, (size_t)num * sizeof(uint16_t));
+    return true;
+  }
+
+  inline bool read(const char *addr, int num, std::vector<uint16_t> &data) {
+    data.resize(num > 0 ? num : 0);
+    return read(addr, num, data.data());
+  }
+
+  inline bool read(const char *addr, uint16_t &data) {
+    return read(addr, 1, &data);
+  }
+
+  // Ghi thẳng xuống PLC rồi cập nhật bản sao. Lần ghi được tính như một lần
+  // đọc của các segment liên quan.
+  inline bool write(const char *addr, int num, const uint16_t *data) {
+    size_t offset = 0;
+    if (!locate(addr, num, offset) || !engine_.write_range(addr, num, data)) {
+      return false;
+    }
+    const size_t words = (size_t)params_.segment_words;
+    const size_t first = offset / words;
+    const size_t last  = (offset + (size_t)num - 1) / words;
+
+    std::unique_lock<std::shared_mutex> lock(data_mutex_);
+    memcpy(data_.data() + offset, data, (size_t)num * sizeof(uint16_t));
+    for (size_t i = first; i <= last; i++) {
+      segments_[i].sequence++;
+      segments_[i].write_generation++;
+      segments_[i].reads.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  inline bool write(const char                  *addr,
+                    int                          num,
+                    const std::vector<uint16_t> &data) {
+    if (num < 0 || data.size() < (size_t)num) {
+      std::cerr << "Data vector size (" << data.size()
+                << ") is smaller than requested write count (" << num << ")"
+                << std::endl;
+      return false;
+    }
+    return write(addr, num, data.data());
+  }
+
+  // Số lần dữ liệu của segment chứa addr đã đổi, dùng để phát hiện thay đổi
+  // mà không cần so sánh dữ liệu. Trả về 0 nếu addr nằm ngoài mirror.
+  inline uint64_t sequence(const char *addr) {
+    size_t offset = 0;
+    if (!locate(addr, 1, offset)) {
+      return 0;
+    }
+    std::shared_lock<std::shared_mutex> lock(data_mutex_);
+    return segments_[offset / (size_t)params_.segment_words].sequence;
+  }
+
+  inline MirrorTier tier(const char *addr) {
+    size_t offset = 0;
+    if (!locate(addr, 1, offset)) {
+      return MirrorTier::COLD;
+    }
+    std::shared_lock<std::shared_mutex> lock(data_mutex_);
+    return segments_[offset / (size_t)params_.segment_words].tier;
+  }
+
+  inline MirrorStats stats() {
+    std::shared_lock<std::shared_mutex> lock(data_mutex_);
+    MirrorStats                         stats = stats_;
+    for (size_t i = 0; i < segment_count_; i++) {
+      if (segments_[i].tier == MirrorTier::HOT) {
+        stats.hot_segments++;
+      }
+    }
+    return stats;
+  }
+
+  // Làm mới trên thread hiện tại tới khi stop(), ngủ tới lúc segment gần
+  // nhất đến hạn
+  inline void run() {
+    running_ = true;
+    loop();
+  }
+
+  // Như run() nhưng trong thread nền
+  inline void start() {
+    if (running_.exchange(true)) {
+      return;
+    }
+    worker_ = std::thread([this]() {
+      trace_set_thread_name("mirror " + addr_);
+      loop();
+    });
+  }
+
+  inline void stop() {
+    {
+      std::lock_guard<std::mutex> lock(wake_mutex_);
+      running_ = false;
+    }
+    wake_cv_.notify_all();
+    if (worker_.joinable() && worker_.get_id() != std::this_thread::get_id()) {
+      worker_.join();
+    }
+  }
+};
+
+}  // namespace plc_slmp
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "test_slmp/device_address.hpp"
+#include "test_slmp/plc_client.hpp"
+#include "test_slmp/shm_client.hpp"
+#include "test_slmp/trace.hpp"
+#include "test_slmp/transfer_engine.hpp"
+
+namespace plc_slmp {
+
+// Một khối thanh ghi được broker poll và công bố
+struct ShmBlockConfig {
+  std::string addr;
+  int         num = 0;
+};
+
+// Chu kỳ kiểm tra hàng đợi ghi giữa hai lần poll
+constexpr std::chrono::milliseconds kShmWritePoll{1};
+
+// Một kết nối PLC dùng chung cho nhiều tiến trình: poll các khối thanh ghi
+// theo chu kỳ, công bố image vào POSIX shared memory (mỗi khối có seqlock
+// và sequence riêng, chỉ tăng khi dữ liệu khối thay đổi) và thực hiện các
+// yêu cầu ghi mà ShmImageClient đưa vào hàng đợi shared memory.
+class ShmBroker {
+private:
+  PlcClient                  &plc_;
+  TransferEngine              engine_;
+  std::string                 name_;
+  std::vector<ShmBlockConfig> blocks_;
+  uint32_t                    total_words_ = 0;
+
+  ShmSegment      image_;
+  ShmSegment      queue_segment_;
+  ShmWriteQueue   queue_;
+  ShmImageHeader *header_ = nullptr;
+  ShmBlockInfo   *infos_  = nullptr;
+  uint16_t       *data_   = nullptr;
+
+  std::vector<RangeRead> ranges_;
+  std::vector<uint16_t>  staging_;
+
+  std::atomic<bool> running_{false};
+  std::thread       worker_;
+
+  // Ghi khối i từ staging_ vào image theo seqlock
+  inline void publish_block(size_t i) {
+    SLMP_TRACE_SCOPE_WORDS("publish_block", "broker", infos_[i].num);
+    ShmBlockInfo &info = infos_[i];
+    const size_t  n    = (size_t)info.num * sizeof(uint16_t);
+    if (info.status.load(std::memory_order_relaxed) ==
+          (uint32_t)ShmBlockStatus::OK &&
+        memcmp(data_ + info.offset, staging_.data() + info.offset, n) == 0) {
+      return;
+    }
+
+    uint64_t seq = info.sequence.load(std::memory_order_relaxed);
+    info.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(data_ + info.offset, staging_.data() + info.offset, n);
+    info.update_ns.store(shm_now_ns(), std::memory_order_relaxed);
+    info.status.store((uint32_t)ShmBlockStatus::OK, std::memory_order_relaxed);
+    info.sequence.store(seq + 2, std::memory_order_release);
+  }
+
+  // Vòng poll của run()/start(), không đổi running_
+  inline void loop(std::chrono::milliseconds period) {
+    auto next = std::chrono::steady_clock::now();
+    while (running_) {
+      process_writes();
+      poll_once();
+
+      next += period;
+      auto now = std::chrono::steady_clock::now();
+      while (running_ && now < next) {
+        if (process_writes() == 0) {
+          std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(
+            kShmWritePoll, next - now));
+        }
+        now = std::chrono::steady_clock::now();
+      }
+      if (next < now) {
+        next = now;  // Chu kỳ bị trễ: bỏ qua thay vì poll dồn
+      }
+    }
+  }
+
+public:
+  ShmBroker(PlcClient                  &plc,
+            std::string                 name,
+            std::vector<ShmBlockConfig> blocks,
+            TransferParams              params = {})
+    : plc_(plc),
+      engine_(plc, params),
+      name_(std::move(name)),
+      blocks_(std::move(blocks)) {
+  }
+
+  ~ShmBroker() {
+    stop();
+  }
+
+  // Tạo segment image (quyền image_mode) và hàng đợi ghi (queue_mode).
+  // Segment của broker cũ đã chết được xóa trước; nếu broker cùng tên còn
+  // chạy thì thất bại. Segment bị xóa khi broker bị hủy.
+  inline bool create(mode_t image_mode = kShmImageMode,
+                     mode_t queue_mode = kShmQueueMode) {
+    total_words_ = 0;
+    for (const ShmBlockConfig &block : blocks_) {
+      if (block.addr.size() >= kMaxAddressLength ||
+          !plc_.is_valid_register_address(block.addr.c_str()) ||
+          block.num <= 0) {
+        std::cerr << "Invalid broker block: " << block.addr << " x "
+                  << block.num << std::endl;
+        return false;
+      }
+      total_words_ += (uint32_t)block.num;
+    }
+    if (blocks_.empty()) {
+      std::cerr << "Broker has no blocks to publish" << std::endl;
+      return false;
+    }
+
+    const uint32_t count = (uint32_t)blocks_.size();
+    if (!shm_remove_stale(name_) ||
+        !image_.create(shm_image_name(name_),
+                       shm_image_size(count, total_words_),
+                       image_mode)) {
+      return false;
+    }
+
+    // ftruncate trả về vùng nhớ toàn 0, chỉ cần ghi các trường khác 0.
+    // owner_pid ghi đầu tiên để broker khác nhận ra segment đang được tạo.
+    char *base = (char *)image_.data();
+    header_    = (ShmImageHeader *)base;
+    infos_     = (ShmBlockInfo *)(base + sizeof(ShmImageHeader));
+    data_      = (uint16_t *)(base + shm_image_data_offset(count));
+    header_->owner_pid = (int32_t)getpid();
+    header_->version   = kShmVersion;
+    if (!queue_segment_.create(
+          shm_queue_name(name_), shm_queue_size(), queue_mode)) {
+      image_.close();
+      header_ = nullptr;
+      return false;
+    }
+    header_->block_count = count;
+    header_->total_words = total_words_;
+    header_->heartbeat_ns.store(shm_now_ns(), std::memory_order_relaxed);
+
+    staging_.assign(total_words_, 0);
+    ranges_.clear();
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      strncpy(infos_[i].addr, blocks_[i].addr.c_str(), kMaxAddressLength - 1);
+      infos_[i].num    = blocks_[i].num;
+      infos_[i].offset = offset;
+
+      RangeRead range;
+      range.addr = infos_[i].addr;
+      range.num  = blocks_[i].num;
+      range.data = staging_.data() + offset;
+      ranges_.push_back(range);
+      offset += (uint32_t)blocks_[i].num;
+    }
+
+    queue_ = ShmWriteQueue(queue_segment_.data());
+    queue_.init();
+
+    // magic ghi sau cùng: client chỉ attach khi header đã đầy đủ
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = kShmMagic;
+    return true;
+  }
+
+  // Đọc mọi khối và công bố khối nào thay đổi. Nếu lần đọc gộp lỗi thì đọc
+  // lại từng khối để một khối lỗi không làm dừng các khối khác.
+  inline bool poll_once() {
+    SLMP_TRACE_SCOPE("poll", "broker");
+    bool ok = engine_.read_ranges(ranges_.data(), ranges_.size());
+    if (ok) {
+      for (size_t i = 0; i < ranges_.size(); i++) {
+        publish_block(i);
+      }
+    } else {
+      ok = true;
+      for (size_t i = 0; i < ranges_.size(); i++) {
+        if (engine_.read_range(ranges_[i].addr,
+                               ranges_[i].num,
+                               ranges_[i].data)) {
+          publish_block(i);
+        } else {
+          infos_[i].status.store((uint32_t)ShmBlockStatus::READ_ERROR,
+                                 std::memory_order_release);
+          ok = false;
+        }
+      }
+    }
+    header_->cycle.fetch_add(1, std::memory_order_relaxed);
+    header_->heartbeat_ns.store(shm_now_ns(), std::memory_order_release);
+    return ok;
+  }
+
+  // Thực hiện các yêu cầu ghi đang chờ, trả về số yêu cầu đã xử lý
+  inline size_t process_writes() {
+    size_t count = 0;
+    while (queue_.try_pop([this](const char *addr, int num, const uint16_t *d) {
+      SLMP_TRACE_SCOPE_WORDS("queued_write", "broker", num);
+      return engine_.write_range(addr, num, d);
+    })) {
+      count++;
+    }
+    return count;
+  }
+
+  // Poll theo chu kỳ period trên thread hiện tại tới khi stop(). Giữa hai
+  // lần poll, hàng đợi ghi được kiểm tra mỗi kShmWritePoll.
+  inline void run(std::chrono::milliseconds period) {
+    running_ = true;
+    loop(period);
+  }
+
+  // Như run() nhưng trong thread nền
+  inline void start(std::chrono::milliseconds period) {
+    if (running_.exchange(true)) {
+      return;
+    }
+    worker_ = std::thread([this, period]() { loop(period); });
+  }
+
+  inline void stop() {
+    running_ = false;
+    if (worker_.joinable() && worker_.get_id() != std::this_thread::get_id()) {
+      worker_.join();
+    }
+  }
+
+  inline uint64_t cycle() const {
+    return header_ != nullptr ? header_->cycle.load() : 0;
+  }
+};
+
+}  // namespace plc_slmp
@@ -0,0 +1,615 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <signal.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include "test_slmp/buffer_pool.hpp"
+#include "test_slmp/device_address.hpp"
+
+// Layout shared memory dùng chung giữa ShmBroker và ShmImageClient. Header
+// này không phụ thuộc libmelcli để tiến trình chỉ đọc dữ liệu (HMI,
+// historian, ...) không cần kết nối PLC.
+
+namespace plc_slmp {
+
+constexpr uint32_t kShmMagic         = 0x504D4C53;  // "SLMP"
+constexpr uint32_t kShmVersion       = 2;
+constexpr uint32_t kShmQueueCapacity = 64;  // Lũy thừa của 2
+constexpr int      kShmMaxWriteWords = kMaxBatchWords;
+
+// Quyền mặc định của segment: tiến trình khác chỉ đọc được image, chỉ user
+// của broker gửi được lệnh ghi. umask của broker vẫn được áp dụng.
+constexpr mode_t kShmImageMode = 0644;
+constexpr mode_t kShmQueueMode = 0600;
+
+// Segment chưa khởi tạo xong (broker chết giữa create()) được coi là bỏ
+// lại sau khoảng này
+constexpr std::chrono::seconds kShmStaleAfter{10};
+
+// Trạng thái của một khối trong image
+enum class ShmBlockStatus : uint32_t {
+  EMPTY      = 0,  // Chưa đọc được lần nào
+  OK         = 1,
+  READ_ERROR = 2,  // Lần đọc gần nhất lỗi, dữ liệu là của lần đọc trước
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared memory atomics must be lock-free");
+static_assert(std::atomic<int64_t>::is_always_lock_free,
+              "shared memory atomics must be lock-free");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "shared memory atomics must be lock-free");
+
+// Đầu segment image
+struct alignas(kCacheLineSize) ShmImageHeader {
+  uint32_t              magic;
+  uint32_t              version;
+  uint32_t              block_count;
+  uint32_t              total_words;
+  std::atomic<uint64_t> cycle;         // Số vòng poll đã chạy
+  std::atomic<int64_t>  heartbeat_ns;  // steady_clock lúc poll gần nhất
+  int32_t               owner_pid;     // pid của broker tạo segment
+};
+
+// Mô tả một khối. sequence là seqlock: lẻ khi broker đang ghi, tăng 2 mỗi
+// lần dữ liệu của khối thay đổi.
+struct alignas(kCacheLineSize) ShmBlockInfo {
+  char                  addr[kMaxAddressLength];
+  int32_t               num;
+  uint32_t              offset;  // Vị trí (word) trong vùng dữ liệu
+  std::atomic<uint64_t> sequence;
+  std::atomic<int64_t>  update_ns;  // steady_clock lúc dữ liệu thay đổi
+  std::atomic<uint32_t> status;
+};
+
+// Đầu segment hàng đợi ghi. Các vị trí nằm trên cache line riêng.
+struct alignas(kCacheLineSize) ShmQueueHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t capacity;
+  alignas(kCacheLineSize) std::atomic<uint64_t> enqueue_pos;
+  alignas(kCacheLineSize) std::atomic<uint64_t> dequeue_pos;
+};
+
+// Một yêu cầu ghi trong hàng đợi
+struct alignas(kCacheLineSize) ShmWriteSlot {
+  std::atomic<uint64_t> sequence;
+  char                  addr[kMaxAddressLength];
+  int32_t               num;
+  uint16_t              data[kShmMaxWriteWords];
+};
+
+// Kết quả ghi theo ticket, ticket + 1 được ghi sau ok
+struct ShmWriteResult {
+  std::atomic<uint64_t> ticket;
+  std::atomic<uint32_t> ok;
+};
+
+inline int64_t shm_now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+inline std::string shm_image_name(const std::string &name) {
+  return "/test_slmp." + name + ".image";
+}
+
+inline std::string shm_queue_name(const std::string &name) {
+  return "/test_slmp." + name + ".writes";
+}
+
+inline size_t shm_image_data_offset(uint32_t block_count) {
+  return sizeof(ShmImageHeader) + block_count * sizeof(ShmBlockInfo);
+}
+
+inline size_t shm_image_size(uint32_t block_count, uint32_t total_words) {
+  return shm_image_data_offset(block_count) + total_words * sizeof(uint16_t);
+}
+
+inline size_t shm_queue_size() {
+  return sizeof(ShmQueueHeader) + kShmQueueCapacity * sizeof(ShmWriteSlot) +
+         kShmQueueCapacity * sizeof(ShmWriteResult);
+}
+
+// Vùng POSIX shared memory được map vào tiến trình
+class ShmSegment {
+private:
+  std::string name_;
+  void       *addr_  = nullptr;
+  size_t      size_  = 0;
+  bool        owner_ = false;
+
+public:
+  ShmSegment() = default;
+  ShmSegment(const ShmSegment &)            = delete;
+  ShmSegment &operator=(const ShmSegment &) = delete;
+
+  ~ShmSegment() {
+    close();
+  }
+
+  // Tạo mới với kích thước size và quyền mode (sau umask). Thất bại nếu
+  // segment cùng tên đã tồn tại.
+  inline bool create(const std::string &name, size_t size, mode_t mode) {
+    close();
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, mode);
+    if (fd < 0) {
+      std::cerr << "Failed to create shared memory " << name << ": "
+                << strerror(errno) << std::endl;
+      return false;
+    }
+    if (ftruncate(fd, (off_t)size) != 0) {
+      std::cerr << "Failed to size shared memory " << name << ": "
+                << strerror(errno) << std::endl;
+      ::close(fd);
+      shm_unlink(name.c_str());
+      return false;
+    }
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+      std::cerr << "Failed to map shared memory " << name << ": "
+                << strerror(errno) << std::endl;
+      shm_unlink(name.c_str());
+      return false;
+    }
+    name_  = name;
+    addr_  = addr;
+    size_  = size;
+    owner_ = true;
+    return true;
+  }
+
+  // Map segment có sẵn với toàn bộ kích thước của nó
+  inline bool open(const std::string &name, bool writable) {
+    close();
+    int fd = shm_open(name.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+    if (fd < 0) {
+      std::cerr << "Failed to open shared memory " << name << ": "
+                << strerror(errno) << std::endl;
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+      std::cerr << "Invalid shared memory " << name << std::endl;
+      ::close(fd);
+      return false;
+    }
+    int   prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void *addr = mmap(nullptr, (size_t)st.st_size, prot, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+      std::cerr << "Failed to map shared memory " << name << ": "
+                << strerror(errno) << std::endl;
+      return false;
+    }
+    name_  = name;
+    addr_  = addr;
+    size_  = (size_t)st.st_size;
+    owner_ = false;
+    return true;
+  }
+
+  // Unmap; segment do create() tạo thì bị xóa luôn
+  inline void close() {
+    if (addr_ != nullptr) {
+      munmap(addr_, size_);
+      if (owner_) {
+        shm_unlink(name_.c_str());
+      }
+    }
+    addr_  = nullptr;
+    size_  = 0;
+    owner_ = false;
+  }
+
+  inline void *data() const {
+    return addr_;
+  }
+
+  inline size_t size() const {
+    return size_;
+  }
+};
+
+// Xóa segment image và hàng đợi của name nếu broker tạo ra chúng không
+// còn chạy (owner_pid đã chết, hoặc segment chưa khởi tạo xong sau
+// kShmStaleAfter). Trả về false nếu segment đang thuộc một broker còn sống
+// hoặc không kiểm tra được.
+inline bool shm_remove_stale(const std::string &name) {
+  const std::string image = shm_image_name(name);
+  int               fd    = shm_open(image.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return true;
+    }
+    std::cerr << "Failed to open shared memory " << image << ": "
+              << strerror(errno) << std::endl;
+    return false;
+  }
+
+  struct stat st;
+  bool        alive = true;
+  int32_t     pid   = 0;
+  if (fstat(fd, &st) == 0) {
+    if ((size_t)st.st_size >= sizeof(ShmImageHeader)) {
+      void *addr =
+        mmap(nullptr, sizeof(ShmImageHeader), PROT_READ, MAP_SHARED, fd, 0);
+      if (addr != MAP_FAILED) {
+        const ShmImageHeader *header = (const ShmImageHeader *)addr;
+        if (header->version == kShmVersion) {
+          pid = header->owner_pid;
+        }
+        munmap(addr, sizeof(ShmImageHeader));
+      }
+    }
+    if (pid > 0) {
+      alive = kill(pid, 0) == 0 || errno == EPERM;
+    } else {
+      auto age = std::chrono::system_clock::now() -
+                 std::chrono::system_clock::from_time_t(st.st_ctime);
+      alive = age < kShmStaleAfter;
+    }
+  }
+  ::close(fd);
+
+  if (alive) {
+    std::cerr << "Shared memory " << image << " is in use";
+    if (pid > 0) {
+      std::cerr << " by broker pid " << pid;
+    }
+    std::cerr << std::endl;
+    return false;
+  }
+  std::cerr << "Removing stale shared memory " << image << std::endl;
+  shm_unlink(image.c_str());
+  shm_unlink(shm_queue_name(name).c_str());
+  return true;
+}
+
+// Hàng đợi ghi MPMC không khóa (bounded, mỗi slot có sequence riêng) trên
+// segment hàng đợi. Một producer chết giữa try_push sẽ chặn slot của nó,
+// broker cần được khởi động lại trong trường hợp đó.
+class ShmWriteQueue {
+private:
+  ShmQueueHeader *header_  = nullptr;
+  ShmWriteSlot   *slots_   = nullptr;
+  ShmWriteResult *results_ = nullptr;
+
+  static constexpr uint64_t kMask = kShmQueueCapacity - 1;
+
+public:
+  ShmWriteQueue() = default;
+
+  explicit ShmWriteQueue(void *base)
+    : header_((ShmQueueHeader *)base),
+      slots_((ShmWriteSlot *)((char *)base + sizeof(ShmQueueHeader))),
+      results_((ShmWriteResult *)((char *)slots_ +
+                                  kShmQueueCapacity * sizeof(ShmWriteSlot))) {
+  }
+
+  // Khởi tạo segment mới (broker)
+  inline void init() {
+    header_->magic    = kShmMagic;
+    header_->version  = kShmVersion;
+    header_->capacity = kShmQueueCapacity;
+    header_->enqueue_pos.store(0, std::memory_order_relaxed);
+    header_->dequeue_pos.store(0, std::memory_order_relaxed);
+    for (uint64_t i = 0; i < kShmQueueCapacity; i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+      results_[i].ticket.store(0, std::memory_order_relaxed);
+      results_[i].ok.store(0, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  inline bool valid() const {
+    return header_ != nullptr && header_->magic == kShmMagic &&
+           header_->version == kShmVersion &&
+           header_->capacity == kShmQueueCapacity;
+  }
+
+  // Đưa yêu cầu ghi vào hàng đợi. Trả về false nếu hàng đợi đầy hoặc num
+  // nằm ngoài [1, kShmMaxWriteWords].
+  inline bool try_push(const char     *addr,
+                       int             num,
+                       const uint16_t *data,
+                       uint64_t       &ticket) {
+    if (num < 1 || num > kShmMaxWriteWords) {
+      return false;
+    }
+    uint64_t      pos = header_->enqueue_pos.load(std::memory_order_relaxed);
+    ShmWriteSlot *slot;
+    while (true) {
+      slot         = &slots_[pos & kMask];
+      uint64_t seq = slot->sequence.load(std::memory_order_acquire);
+      int64_t  diff = (int64_t)seq - (int64_t)pos;
+      if (diff == 0) {
+        if (header_->enqueue_pos.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = header_->enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    strncpy(slot->addr, addr, kMaxAddressLength - 1);
+    slot->addr[kMaxAddressLength - 1] = '\0';
+    slot->num                         = num;
+    memcpy(slot->data, data, (size_t)num * sizeof(uint16_t));
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    ticket = pos;
+    return true;
+  }
+
+  // Lấy yêu cầu ghi tiếp theo. fn(addr, num, data) trả về kết quả ghi.
+  // Slot có thể bị tiến trình khác có quyền ghi segment sửa tùy ý, nên num
+  // và addr được copy ra rồi kiểm tra trước khi gọi fn; yêu cầu sai được
+  // trả kết quả lỗi mà không ghi. Trả về false nếu hàng đợi rỗng.
+  template <typename Fn>
+  inline bool try_pop(Fn fn) {
+    uint64_t      pos = header_->dequeue_pos.load(std::memory_order_relaxed);
+    ShmWriteSlot *slot;
+    while (true) {
+      slot          = &slots_[pos & kMask];
+      uint64_t seq  = slot->sequence.load(std::memory_order_acquire);
+      int64_t  diff = (int64_t)seq - (int64_t)(pos + 1);
+      if (diff == 0) {
+        if (header_->dequeue_pos.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = header_->dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    char    addr[kMaxAddressLength];
+    int32_t num = slot->num;
+    memcpy(addr, slot->addr, sizeof(addr));
+    bool ok = false;
+    if (num >= 1 && num <= kShmMaxWriteWords &&
+        addr[kMaxAddressLength - 1] == '\0') {
+      ok = fn((const char *)addr, (int)num, slot->data);
+    } else {
+      std::cerr << "Rejecting malformed write request " << pos << std::endl;
+    }
+    ShmWriteResult &result = results_[pos & kMask];
+    result.ok.store(ok ? 1 : 0, std::memory_order_relaxed);
+    result.ticket.store(pos + 1, std::memory_order_release);
+    slot->sequence.store(pos + kShmQueueCapacity, std::memory_order_release);
+    return true;
+  }
+
+  // Kết quả của ticket: 1 ghi thành công, 0 ghi lỗi, -1 chưa xử lý, -2 kết
+  // quả đã bị ghi đè bởi các yêu cầu sau
+  inline int result(uint64_t ticket) const {
+    const ShmWriteResult &r    = results_[ticket & kMask];
+    uint64_t              done = r.ticket.load(std::memory_order_acquire);
+    if (done == ticket + 1) {
+      return r.ok.load(std::memory_order_relaxed) ? 1 : 0;
+    }
+    return done > ticket + 1 ? -2 : -1;
+  }
+};
+
+// Đọc register image do ShmBroker công bố và gửi yêu cầu ghi qua broker.
+// Segment image được map chỉ đọc; mọi lần đọc khối dùng seqlock nên luôn
+// nhận được dữ liệu của một lần poll trọn vẹn.
+class ShmImageClient {
+private:
+  std::string           name_;
+  ShmSegment            image_;
+  ShmSegment            queue_segment_;
+  ShmWriteQueue         queue_;
+  const ShmImageHeader *header_ = nullptr;
+  const ShmBlockInfo   *blocks_ = nullptr;
+  const uint16_t       *data_   = nullptr;
+
+  // Copy words word từ offset của khối theo seqlock
+  inline bool copy_block(const ShmBlockInfo &block,
+                         size_t              offset,
+                         int                 words,
+                         uint16_t           *dst,
+                         uint64_t           *sequence) const {
+    while (true) {
+      uint64_t before = block.sequence.load(std::memory_order_acquire);
+      if (before & 1) {
+        std::this_thread::yield();
+        continue;
+      }
+      memcpy(dst,
+             data_ + block.offset + offset,
+             (size_t)words * sizeof(uint16_t));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (block.sequence.load(std::memory_order_relaxed) == before) {
+        if (sequence != nullptr) {
+          *sequence = before;
+        }
+        return block.status.load(std::memory_order_relaxed) !=
+               (uint32_t)ShmBlockStatus::EMPTY;
+      }
+    }
+  }
+
+public:
+  explicit ShmImageClient(std::string name) : name_(std::move(name)) {
+  }
+
+  // Map segment của broker. Gọi lại được để attach lại khi broker khởi
+  // động lại.
+  inline bool attach() {
+    detach();
+    if (!image_.open(shm_image_name(name_), false)) {
+      return false;
+    }
+    header_ = (const ShmImageHeader *)image_.data();
+    if (image_.size() < sizeof(ShmImageHeader) ||
+        header_->magic != kShmMagic || header_->version != kShmVersion ||
+        image_.size() <
+          shm_image_size(header_->block_count, header_->total_words)) {
+      std::cerr << "Incompatible shared memory image: " << name_ << std::endl;
+      detach();
+      return false;
+    }
+    blocks_ = (const ShmBlockInfo *)((const char *)image_.data() +
+                                     sizeof(ShmImageHeader));
+    data_   = (const uint16_t *)((const char *)image_.data() +
+                               shm_image_data_offset(header_->block_count));
+
+    if (queue_segment_.open(shm_queue_name(name_), true) &&
+        queue_segment_.size() >= shm_queue_size()) {
+      queue_ = ShmWriteQueue(queue_segment_.data());
+      if (!queue_.valid()) {
+        queue_ = ShmWriteQueue();
+      }
+    }
+    return true;
+  }
+
+  inline void detach() {
+    image_.close();
+    queue_segment_.close();
+    queue_  = ShmWriteQueue();
+    header_ = nullptr;
+    blocks_ = nullptr;
+    data_   = nullptr;
+  }
+
+  inline bool attached() const {
+    return header_ != nullptr;
+  }
+
+  inline size_t block_count() const {
+    return header_ != nullptr ? header_->block_count : 0;
+  }
+
+  inline const char *block_addr(size_t i) const {
+    return blocks_[i].addr;
+  }
+
+  inline int block_size(size_t i) const {
+    return blocks_[i].num;
+  }
+
+  // Sequence hiện tại của khối, đổi khi dữ liệu khối thay đổi
+  inline uint64_t block_sequence(size_t i) const {
+    return blocks_[i].sequence.load(std::memory_order_acquire) & ~1ull;
+  }
+
+  inline ShmBlockStatus block_status(size_t i) const {
+    return (ShmBlockStatus)blocks_[i].status.load(std::memory_order_acquire);
+  }
+
+  // Broker còn chạy nếu đã poll trong khoảng max_age
+  inline bool broker_alive(std::chrono::milliseconds max_age) const {
+    if (header_ == nullptr) {
+      return false;
+    }
+    int64_t age = shm_now_ns() -
+                  header_->heartbeat_ns.load(std::memory_order_acquire);
+    return age <= std::chrono::nanoseconds(max_age).count();
+  }
+
+  // Đọc cả khối i vào dst[0..block_size(i)). sequence (nếu có) nhận
+  // sequence của dữ liệu đã đọc.
+  inline bool read_block(size_t i, uint16_t *dst, uint64_t *sequence = nullptr)
+    const {
+    if (header_ == nullptr || i >= header_->block_count) {
+      return false;
+    }
+    return copy_block(blocks_[i], 0, blocks_[i].num, dst, sequence);
+  }
+
+  // Đọc num word từ addr, vùng này phải nằm gọn trong một khối
+  inline bool read(const char *addr, int num, uint16_t *dst) const {
+    DeviceAddress start = parse_device_address(addr);
+    if (header_ == nullptr || !start.valid() || num <= 0) {
+      return false;
+    }
+    const uint32_t ppw = points_per_word(start.type);
+    for (uint32_t i = 0; i < header_->block_count; i++) {
+      DeviceAddress block = parse_device_address(blocks_[i].addr);
+      if (block.type != start.type || start.number < block.number ||
+          (start.number - block.number) % ppw != 0) {
+        continue;
+      }
+      size_t offset = (start.number - block.number) / ppw;
+      if (offset + (size_t)num <= (size_t)blocks_[i].num) {
+        return copy_block(blocks_[i], offset, num, dst, nullptr);
+      }
+    }
+    std::cerr << "Range " << addr << " x " << num
+              << " is not published by the broker" << std::endl;
+    return false;
+  }
+
+  // Gửi yêu cầu ghi tới broker. ticket (nếu có) dùng cho wait_write().
+  inline bool write(const char     *addr,
+                    int             num,
+                    const uint16_t *data,
+                    uint64_t       *ticket = nullptr) {
+    if (!queue_.valid()) {
+      std::cerr << "Broker write queue is not available" << std::endl;
+      return false;
+    }
+    if (!parse_device_address(addr).valid() || num <= 0 ||
+        num > kShmMaxWriteWords) {
+      std::cerr << "Invalid write request: " << addr << " x " << num
+                << std::endl;
+      return false;
+    }
+    uint64_t t;
+    if (!queue_.try_push(addr, num, data, t)) {
+      std::cerr << "Broker write queue is full" << std::endl;
+      return false;
+    }
+    if (ticket != nullptr) {
+      *ticket = t;
+    }
+    return true;
+  }
+
+  // Chờ broker ghi xong yêu cầu ticket. Trả về true nếu ghi thành công.
+  inline bool wait_write(uint64_t                  ticket,
+                         std::chrono::milliseconds timeout) const {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (queue_.valid()) {
+      int result = queue_.result(ticket);
+      if (result >= 0) {
+        return result == 1;
+      }
+      if (result == -2) {
+        std::cerr << "Write result " << ticket << " was overwritten"
+                  << std::endl;
+        return false;
+      }
+      if (std::chrono::steady_clock::now() >= deadline) {
+        std::cerr << "Timed out waiting for write " << ticket << std::endl;
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    return false;
+  }
+};
+
+}  // namespace plc_slmp
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define TEST_SLMP_BIG_ENDIAN 1
+#else
+#define TEST_SLMP_BIG_ENDIAN 0
+#endif
+
+namespace plc_slmp {
+
+// So sánh hai mảng word và ghi lại offset của các phần tử khác nhau.
+// Dùng AVX2/SSE2/NEON khi có, so sánh theo khối và chỉ đi vào vòng lặp
+// scalar khi khối đó có ít nhất một word không khớp.
+inline void find_word_mismatches(const uint16_t   *expected,
+                                 const uint16_t   *actual,
+                                 size_t            num,
+                                 std::vector<int> &offsets) {
+  size_t i = 0;
+
+#if defined(__AVX2__)
+  for (; i + 16 <= num; i += 16) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(expected + i));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(actual + i));
+    uint32_t mask =
+      (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b));
+    if (mask != 0xFFFFFFFFu) {
+      for (size_t j = 0; j < 16; j++) {
+        if (expected[i + j] != actual[i + j]) {
+          offsets.push_back((int)(i + j));
+        }
+      }
+    }
+  }
+#endif
+
+#if defined(__SSE2__)
+  for (; i + 8 <= num; i += 8) {
+    __m128i a    = _mm_loadu_si128((const __m128i *)(expected + i));
+    __m128i b    = _mm_loadu_si128((const __m128i *)(actual + i));
+    int     mask = _mm_movemask_epi8(_mm_cmpeq_epi16(a, b));
+    if (mask != 0xFFFF) {
+      for (size_t j = 0; j < 8; j++) {
+        if (expected[i + j] != actual[i + j]) {
+          offsets.push_back((int)(i + j));
+        }
+      }
+    }
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  for (; i + 8 <= num; i += 8) {
+    uint16x8_t eq = vceqq_u16(vld1q_u16(expected + i), vld1q_u16(actual + i));
+    if (vminvq_u16(eq) != 0xFFFF) {
+      for (size_t j = 0; j < 8; j++) {
+        if (expected[i + j] != actual[i + j]) {
+          offsets.push_back((int)(i + j));
+        }
+      }
+    }
+  }
+#endif
+
+  for (; i < num; i++) {
+    if (expected[i] != actual[i]) {
+      offsets.push_back((int)i);
+    }
+  }
+}
+
+// Copy num word little-endian (dữ liệu binary của SLMP) sang word của máy.
+// Trên máy little-endian chỉ là memcpy.
+inline void load_le_words(const uint8_t *src, size_t num, uint16_t *dst) {
+#if TEST_SLMP_BIG_ENDIAN
+  for (size_t i = 0; i < num; i++) {
+    dst[i] = (uint16_t)(src[2 * i] | (src[2 * i + 1] << 8));
+  }
+#else
+  memcpy(dst, src, num * sizeof(uint16_t));
+#endif
+}
+
+inline void store_le_words(const uint16_t *src, size_t num, uint8_t *dst) {
+#if TEST_SLMP_BIG_ENDIAN
+  for (size_t i = 0; i < num; i++) {
+    dst[2 * i]     = (uint8_t)(src[i] & 0xFF);
+    dst[2 * i + 1] = (uint8_t)(src[i] >> 8);
+  }
+#else
+  memcpy(dst, src, num * sizeof(uint16_t));
+#endif
+}
+
+inline int hex_nibble(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+// Giải mã word dạng ASCII của SLMP (4 ký tự hex mỗi word, chữ số cao trước).
+// Trả về false nếu gặp ký tự không phải hex.
+inline bool decode_hex_words_scalar(const char *src,
+                                    size_t      num,
+                                    uint16_t   *dst) {
+  for (size_t i = 0; i < num; i++) {
+    int n0 = hex_nibble(src[4 * i]);
+    int n1 = hex_nibble(src[4 * i + 1]);
+    int n2 = hex_nibble(src[4 * i + 2]);
+    int n3 = hex_nibble(src[4 * i + 3]);
+    if ((n0 | n1 | n2 | n3) < 0) {
+      return false;
+    }
+    dst[i] = (uint16_t)((n0 << 12) | (n1 << 8) | (n2 << 4) | n3);
+  }
+  return true;
+}
+
+// Như decode_hex_words_scalar nhưng giải mã 8 word (32 ký tự) mỗi vòng bằng
+// SSE2/NEON: đổi ký tự thành nibble, ghép cặp nibble thành byte, pack rồi
+// đảo byte trong từng word.
+inline bool decode_hex_words(const char *src, size_t num, uint16_t *dst) {
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  const __m128i low4    = _mm_set1_epi8(0x0F);
+  const __m128i nine    = _mm_set1_epi8(9);
+  const __m128i lower   = _mm_set1_epi8(0x20);
+  const __m128i byte0   = _mm_set1_epi16(0x00FF);
+  const __m128i below_0 = _mm_set1_epi8('0' - 1);
+  const __m128i above_9 = _mm_set1_epi8('9' + 1);
+  const __m128i below_a = _mm_set1_epi8('a' - 1);
+  const __m128i above_f = _mm_set1_epi8('f' + 1);
+  for (; i + 8 <= num; i += 8) {
+    __m128i c[2] = {_mm_loadu_si128((const __m128i *)(src + 4 * i)),
+                    _mm_loadu_si128((const __m128i *)(src + 4 * i + 16))};
+    __m128i b[2];
+    for (int k = 0; k < 2; k++) {
+      // Kiểm tra '0'-'9', 'A'-'F', 'a'-'f'
+      __m128i lc    = _mm_or_si128(c[k], lower);
+      __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c[k], below_0),
+                                    _mm_cmplt_epi8(c[k], above_9));
+      __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lc, below_a),
+                                    _mm_cmplt_epi8(lc, above_f));
+      if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xFFFF) {
+        return false;
+      }
+      __m128i nib =
+        _mm_add_epi8(_mm_and_si128(c[k], low4), _mm_and_si128(alpha, nine));
+      b[k] = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nib, byte0), 4),
+                          _mm_srli_epi16(nib, 8));
+    }
+    __m128i bytes = _mm_packus_epi16(b[0], b[1]);
+    __m128i words =
+      _mm_or_si128(_mm_slli_epi16(bytes, 8), _mm_srli_epi16(bytes, 8));
+    _mm_storeu_si128((__m128i *)(dst + i), words);
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  const uint8x16_t low4 = vdupq_n_u8(0x0F);
+  const uint8x16_t nine = vdupq_n_u8(9);
+  for (; i + 8 <= num; i += 8) {
+    uint8x16_t c[2] = {vld1q_u8((const uint8_t *)(src + 4 * i)),
+                       vld1q_u8((const uint8_t *)(src + 4 * i + 16))};
+    uint8x8_t  b[2];
+    for (int k = 0; k < 2; k++) {
+      uint8x16_t lc    = vorrq_u8(c[k], vdupq_n_u8(0x20));
+      uint8x16_t digit = vandq_u8(vcgeq_u8(c[k], vdupq_n_u8('0')),
+                                  vcleq_u8(c[k], vdupq_n_u8('9')));
+      uint8x16_t alpha = vandq_u8(vcgeq_u8(lc, vdupq_n_u8('a')),
+                                  vcleq_u8(lc, vdupq_n_u8('f')));
+      if (vminvq_u8(vorrq_u8(digit, alpha)) != 0xFF) {
+        return false;
+      }
+      uint16x8_t nib = vreinterpretq_u16_u8(
+        vaddq_u8(vandq_u8(c[k], low4), vandq_u8(alpha, nine)));
+      b[k] = vmovn_u16(
+        vorrq_u16(vshlq_n_u16(vandq_u16(nib, vdupq_n_u16(0x00FF)), 4),
+                  vshrq_n_u16(nib, 8)));
+    }
+    uint8x16_t bytes = vrev16q_u8(vcombine_u8(b[0], b[1]));
+    vst1q_u16(dst + i, vreinterpretq_u16_u8(bytes));
+  }
+#endif
+
+  return decode_hex_words_scalar(src + 4 * i, num - i, dst + i);
+}
+
+// Mã hóa word thành 4 ký tự hex viết hoa mỗi word (chế độ ASCII của SLMP)
+inline void encode_hex_words(const uint16_t *src, size_t num, char *dst) {
+  static const char kHex[] = "0123456789ABCDEF";
+  for (size_t i = 0; i < num; i++) {
+    uint16_t w     = src[i];
+    dst[4 * i]     = kHex[(w >> 12) & 0xF];
+    dst[4 * i + 1] = kHex[(w >> 8) & 0xF];
+    dst[4 * i + 2] = kHex[(w >> 4) & 0xF];
+    dst[4 * i + 3] = kHex[w & 0xF];
+  }
+}
+
+// Tách dữ liệu đọc theo đơn vị bit của SLMP binary (mỗi byte chứa 2 điểm,
+// điểm đầu ở nibble cao) thành một byte 0/1 cho mỗi điểm.
+inline void unpack_bit_nibbles_scalar(const uint8_t *src,
+                                      size_t         points,
+                                      uint8_t       *dst) {
+  for (size_t i = 0; i < points; i++) {
+    uint8_t byte = src[i / 2];
+    dst[i]       = (uint8_t)(((i % 2 == 0) ? (byte >> 4) : byte) & 0x01);
+  }
+}
+
+inline void unpack_bit_nibbles(const uint8_t *src,
+                               size_t         points,
+                               uint8_t       *dst) {
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  const __m128i one = _mm_set1_epi8(0x01);
+  for (; i + 32 <= points; i += 32) {
+    __m128i v  = _mm_loadu_si128((const __m128i *)(src + i / 2));
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), one);
+    __m128i lo = _mm_and_si128(v, one);
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128((__m128i *)(dst + i + 16), _mm_unpackhi_epi8(hi, lo));
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  const uint8x16_t one = vdupq_n_u8(0x01);
+  for (; i + 32 <= points; i += 32) {
+    uint8x16_t   v  = vld1q_u8(src + i / 2);
+    uint8x16x2_t hl = {{vandq_u8(vshrq_n_u8(v, 4), one), vandq_u8(v, one)}};
+    vst2q_u8(dst + i, hl);
+  }
+#endif
+
+  unpack_bit_nibbles_scalar(src + i / 2, points - i, dst + i);
+}
+
+}  // namespace plc_slmp
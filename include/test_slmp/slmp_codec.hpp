@@ -0,0 +1,400 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "test_slmp/device_address.hpp"
+#include "test_slmp/simd_utils.hpp"
+
+namespace plc_slmp {
+
+// Loại frame SLMP. 4E có thêm serial number để ghép request với response.
+enum class SlmpFrameType { FRAME_3E, FRAME_4E };
+
+// Mã hóa frame: binary hoặc ASCII (mỗi byte thành chữ số hex)
+enum class SlmpEncoding { BINARY, ASCII };
+
+// Các lệnh SLMP mà codec hỗ trợ
+constexpr uint16_t kSlmpCmdBatchRead  = 0x0401;
+constexpr uint16_t kSlmpCmdBatchWrite = 0x1401;
+constexpr uint16_t kSlmpSubcmdWord    = 0x0000;
+constexpr uint16_t kSlmpSubcmdBit     = 0x0001;
+
+// Số điểm tối đa khi đọc theo đơn vị bit trong một frame
+constexpr int kMaxBatchBits = 7168;
+
+// Tham số đích và định dạng frame
+struct SlmpFrameConfig {
+  SlmpFrameType frame            = SlmpFrameType::FRAME_3E;
+  SlmpEncoding  encoding         = SlmpEncoding::BINARY;
+  uint8_t       network          = 0x00;    // Network No.
+  uint8_t       pc               = 0xFF;    // PC No.
+  uint16_t      module_io        = 0x03FF;  // Request destination module I/O
+  uint8_t       module_station   = 0x00;    // Request destination station
+  uint16_t      monitoring_timer = 0x0010;  // Đơn vị 250 ms
+};
+
+// Response đã tách header. data trỏ vào buffer gốc, không copy.
+struct SlmpResponse {
+  uint16_t       end_code = 0;
+  uint16_t       serial   = 0;
+  const uint8_t *data     = nullptr;
+  size_t         data_len = 0;
+};
+
+// Encoder/decoder frame SLMP 3E/4E, binary hoặc ASCII, chỉ cho batch
+// read/write. Encoder ghi thẳng vào buffer của người gọi (thường là slab
+// của BufferPool), decoder đọc tại chỗ trên buffer nhận. Không cấp phát.
+class SlmpCodec {
+private:
+  SlmpFrameConfig config_;
+
+  inline bool ascii() const {
+    return config_.encoding == SlmpEncoding::ASCII;
+  }
+
+  inline bool frame_4e() const {
+    return config_.frame == SlmpFrameType::FRAME_4E;
+  }
+
+  static inline uint8_t device_code(RegisterType type) {
+    switch (type) {
+      case RegisterType::D_REGISTER:
+        return 0xA8;
+      case RegisterType::X_REGISTER:
+        return 0x9C;
+      case RegisterType::Y_REGISTER:
+        return 0x9D;
+      case RegisterType::M_REGISTER:
+        return 0x90;
+      case RegisterType::B_REGISTER:
+        return 0xA0;
+      case RegisterType::SD_REGISTER:
+        return 0xA9;
+      default:
+        return 0x00;
+    }
+  }
+
+  // Mã thiết bị 2 ký tự ở chế độ ASCII ("D*", "SD", ...)
+  static inline const char *device_symbol(RegisterType type) {
+    switch (type) {
+      case RegisterType::D_REGISTER:
+        return "D*";
+      case RegisterType::X_REGISTER:
+        return "X*";
+      case RegisterType::Y_REGISTER:
+        return "Y*";
+      case RegisterType::M_REGISTER:
+        return "M*";
+      case RegisterType::B_REGISTER:
+        return "B*";
+      case RegisterType::SD_REGISTER:
+        return "SD";
+      default:
+        return "**";
+    }
+  }
+
+  static inline void put_le(uint8_t *p, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+      p[i] = (uint8_t)(value >> (8 * i));
+    }
+  }
+
+  static inline uint32_t get_le(const uint8_t *p, int bytes) {
+    uint32_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+      value = (value << 8) | p[i];
+    }
+    return value;
+  }
+
+  // Ghi value thành digits chữ số theo base, chữ số cao trước
+  static inline void put_text(uint8_t *p,
+                              uint32_t value,
+                              int      digits,
+                              uint32_t base = 16) {
+    static const char kHex[] = "0123456789ABCDEF";
+    for (int i = digits - 1; i >= 0; i--) {
+      p[i] = (uint8_t)kHex[value % base];
+      value /= base;
+    }
+  }
+
+  static inline bool get_text(const uint8_t *p, int digits, uint32_t &value) {
+    value = 0;
+    for (int i = 0; i < digits; i++) {
+      int n = hex_nibble((char)p[i]);
+      if (n < 0) {
+        return false;
+      }
+      value = (value << 4) | (uint32_t)n;
+    }
+    return true;
+  }
+
+  // Ghi phần header chung tới trường request data length, trả về vị trí
+  // của trường length và vị trí bắt đầu phần được tính vào length
+  inline size_t put_header(uint8_t *buf, uint16_t serial, size_t &len_pos)
+    const {
+    size_t pos = 0;
+    if (ascii()) {
+      memcpy(buf, frame_4e() ? "5400" : "5000", 4);
+      pos = 4;
+      if (frame_4e()) {
+        put_text(buf + pos, serial, 4);
+        memcpy(buf + pos + 4, "0000", 4);
+        pos += 8;
+      }
+      put_text(buf + pos, config_.network, 2);
+      put_text(buf + pos + 2, config_.pc, 2);
+      put_text(buf + pos + 4, config_.module_io, 4);
+      put_text(buf + pos + 8, config_.module_station, 2);
+      len_pos = pos + 10;
+      return pos + 14;
+    }
+
+    buf[0] = frame_4e() ? 0x54 : 0x50;
+    buf[1] = 0x00;
+    pos    = 2;
+    if (frame_4e()) {
+      put_le(buf + pos, serial, 2);
+      put_le(buf + pos + 2, 0, 2);
+      pos += 4;
+    }
+    buf[pos]     = config_.network;
+    buf[pos + 1] = config_.pc;
+    put_le(buf + pos + 2, config_.module_io, 2);
+    buf[pos + 4] = config_.module_station;
+    len_pos      = pos + 5;
+    return pos + 7;
+  }
+
+  // Ghi monitoring timer, command, subcommand và thiết bị đầu. Trả về vị trí
+  // ngay sau trường số điểm.
+  inline size_t put_request(uint8_t            *buf,
+                            size_t              pos,
+                            uint16_t            command,
+                            uint16_t            subcommand,
+                            const DeviceAddress &start,
+                            int                 points) const {
+    if (ascii()) {
+      put_text(buf + pos, config_.monitoring_timer, 4);
+      put_text(buf + pos + 4, command, 4);
+      put_text(buf + pos + 8, subcommand, 4);
+      memcpy(buf + pos + 12, device_symbol(start.type), 2);
+      put_text(buf + pos + 14, start.number, 6, device_number_base(start.type));
+      put_text(buf + pos + 20, (uint32_t)points, 4);
+      return pos + 24;
+    }
+
+    put_le(buf + pos, config_.monitoring_timer, 2);
+    put_le(buf + pos + 2, command, 2);
+    put_le(buf + pos + 4, subcommand, 2);
+    put_le(buf + pos + 6, start.number, 3);
+    buf[pos + 9] = device_code(start.type);
+    put_le(buf + pos + 10, (uint32_t)points, 2);
+    return pos + 12;
+  }
+
+  inline void put_length(uint8_t *buf, size_t len_pos, size_t length) const {
+    if (ascii()) {
+      put_text(buf + len_pos, (uint32_t)length, 4);
+    } else {
+      put_le(buf + len_pos, (uint32_t)length, 2);
+    }
+  }
+
+public:
+  explicit SlmpCodec(SlmpFrameConfig config = {}) : config_(config) {
+  }
+
+  inline const SlmpFrameConfig &config() const {
+    return config_;
+  }
+
+  // Kích thước lớn nhất của một request/response với num word dữ liệu
+  inline size_t max_frame_size(int num) const {
+    return (ascii() ? 64 : 32) + (size_t)num * (ascii() ? 4 : 2);
+  }
+
+  // Request batch read num word từ start. Trả về độ dài frame hoặc 0 nếu
+  // tham số sai hoặc buffer không đủ.
+  inline size_t encode_read(uint8_t             *buf,
+                            size_t               size,
+                            const DeviceAddress &start,
+                            int                  num,
+                            uint16_t             serial = 0) const {
+    if (!start.valid() || num <= 0 || num > kMaxBatchWords ||
+        size < max_frame_size(0)) {
+      return 0;
+    }
+    size_t len_pos = 0;
+    size_t body    = put_header(buf, serial, len_pos);
+    size_t end =
+      put_request(buf, body, kSlmpCmdBatchRead, kSlmpSubcmdWord, start, num);
+    put_length(buf, len_pos, end - body);
+    return end;
+  }
+
+  // Request batch read num điểm theo đơn vị bit (thiết bị bit)
+  inline size_t encode_read_bits(uint8_t             *buf,
+                                 size_t               size,
+                                 const DeviceAddress &start,
+                                 int                  points,
+                                 uint16_t             serial = 0) const {
+    if (!start.valid() || !is_bit_device(start.type) || points <= 0 ||
+        points > kMaxBatchBits || size < max_frame_size(0)) {
+      return 0;
+    }
+    size_t len_pos = 0;
+    size_t body    = put_header(buf, serial, len_pos);
+    size_t end =
+      put_request(buf, body, kSlmpCmdBatchRead, kSlmpSubcmdBit, start, points);
+    put_length(buf, len_pos, end - body);
+    return end;
+  }
+
+  // Request batch write num word từ data
+  inline size_t encode_write(uint8_t             *buf,
+                             size_t               size,
+                             const DeviceAddress &start,
+                             int                  num,
+                             const uint16_t      *data,
+                             uint16_t             serial = 0) const {
+    if (!start.valid() || num <= 0 || num > kMaxBatchWords ||
+        size < max_frame_size(num)) {
+      return 0;
+    }
+    size_t len_pos = 0;
+    size_t body    = put_header(buf, serial, len_pos);
+    size_t end =
+      put_request(buf, body, kSlmpCmdBatchWrite, kSlmpSubcmdWord, start, num);
+    if (ascii()) {
+      encode_hex_words(data, num, (char *)(buf + end));
+      end += (size_t)num * 4;
+    } else {
+      store_le_words(data, num, buf + end);
+      end += (size_t)num * 2;
+    }
+    put_length(buf, len_pos, end - body);
+    return end;
+  }
+
+  // Số byte header của response, tính tới hết trường response data length
+  inline size_t response_header_size() const {
+    if (ascii()) {
+      return frame_4e() ? 26 : 18;
+    }
+    return frame_4e() ? 13 : 9;
+  }
+
+  // Số byte của end code trong response
+  inline size_t end_code_size() const {
+    return ascii() ? 4 : 2;
+  }
+
+  // Đọc header response (response_header_size() byte). body_len là số byte
+  // còn lại sau header (end code + dữ liệu hoặc thông tin lỗi).
+  inline bool parse_response_header(const uint8_t *buf,
+                                    size_t        &body_len,
+                                    uint16_t      &serial) const {
+    uint32_t value = 0;
+    serial         = 0;
+    if (ascii()) {
+      if (memcmp(buf, frame_4e() ? "D400" : "D000", 4) != 0) {
+        return false;
+      }
+      if (frame_4e() && !get_text(buf + 4, 4, value)) {
+        return false;
+      }
+      serial = (uint16_t)value;
+      if (!get_text(buf + response_header_size() - 4, 4, value)) {
+        return false;
+      }
+      body_len = value;
+    } else {
+      if (buf[0] != (frame_4e() ? 0xD4 : 0xD0) || buf[1] != 0x00) {
+        return false;
+      }
+      if (frame_4e()) {
+        serial = (uint16_t)get_le(buf + 2, 2);
+      }
+      body_len = get_le(buf + response_header_size() - 2, 2);
+    }
+    return body_len >= end_code_size();
+  }
+
+  inline bool parse_end_code(const uint8_t *body, uint16_t &end_code) const {
+    if (ascii()) {
+      uint32_t value = 0;
+      if (!get_text(body, 4, value)) {
+        return false;
+      }
+      end_code = (uint16_t)value;
+      return true;
+    }
+    end_code = (uint16_t)get_le(body, 2);
+    return true;
+  }
+
+  // Tách một response hoàn chỉnh nằm trong buf[0..len)
+  inline bool decode_response(const uint8_t *buf,
+                              size_t         len,
+                              SlmpResponse  &out) const {
+    size_t header = response_header_size();
+    size_t body_len;
+    if (len < header || !parse_response_header(buf, body_len, out.serial) ||
+        len != header + body_len ||
+        !parse_end_code(buf + header, out.end_code)) {
+      return false;
+    }
+    out.data     = buf + header + end_code_size();
+    out.data_len = body_len - end_code_size();
+    return true;
+  }
+
+  // Giải mã dữ liệu batch read theo word vào dst[0..num)
+  inline bool decode_words(const SlmpResponse &resp,
+                           uint16_t           *dst,
+                           int                 num) const {
+    if (ascii()) {
+      if (resp.data_len != (size_t)num * 4) {
+        return false;
+      }
+      return decode_hex_words((const char *)resp.data, num, dst);
+    }
+    if (resp.data_len != (size_t)num * 2) {
+      return false;
+    }
+    load_le_words(resp.data, num, dst);
+    return true;
+  }
+
+  // Giải mã dữ liệu batch read theo bit thành một byte 0/1 mỗi điểm
+  inline bool decode_bits(const SlmpResponse &resp,
+                          uint8_t            *dst,
+                          int                 points) const {
+    if (ascii()) {
+      if (resp.data_len != (size_t)points) {
+        return false;
+      }
+      for (int i = 0; i < points; i++) {
+        if (resp.data[i] != '0' && resp.data[i] != '1') {
+          return false;
+        }
+        dst[i] = (uint8_t)(resp.data[i] - '0');
+      }
+      return true;
+    }
+    if (resp.data_len != ((size_t)points + 1) / 2) {
+      return false;
+    }
+    unpack_bit_nibbles(resp.data, points, dst);
+    return true;
+  }
+};
+
+}  // namespace plc_slmp
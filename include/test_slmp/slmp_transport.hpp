@@ -0,0 +1,161 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace plc_slmp {
+
+// Socket TCP/UDP blocking có timeout cho backend SLMP native
+class SlmpSocket {
+private:
+  int  fd_  = -1;
+  bool udp_ = false;
+
+public:
+  SlmpSocket() = default;
+  SlmpSocket(const SlmpSocket &)            = delete;
+  SlmpSocket &operator=(const SlmpSocket &) = delete;
+
+  ~SlmpSocket() {
+    close();
+  }
+
+  inline bool open(const std::string &ip, int port, bool udp, int timeout_ms) {
+    close();
+    udp_ = udp;
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons((uint16_t)port);
+    if (inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) != 1) {
+      std::cerr << "Invalid PLC IP address: " << ip << std::endl;
+      return false;
+    }
+
+    fd_ = ::socket(AF_INET, udp ? SOCK_DGRAM : SOCK_STREAM, 0);
+    if (fd_ < 0) {
+      std::cerr << "Failed to create socket: " << strerror(errno) << std::endl;
+      return false;
+    }
+
+    timeval tv{};
+    tv.tv_sec  = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    if (!udp) {
+      int one = 1;
+      setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    if (::connect(fd_, (const sockaddr *)&addr, sizeof(addr)) != 0) {
+      std::cerr << "Failed to connect to " << ip << ":" << port << ": "
+                << strerror(errno) << std::endl;
+      close();
+      return false;
+    }
+    return true;
+  }
+
+  inline void close() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  inline bool is_open() const {
+    return fd_ >= 0;
+  }
+
+  inline bool udp() const {
+    return udp_;
+  }
+
+  inline int fd() const {
+    return fd_;
+  }
+
+  inline bool send_all(const uint8_t *buf, size_t len) {
+    while (len > 0) {
+      ssize_t n = ::send(fd_, buf, len, MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        std::cerr << "Failed to send SLMP frame: " << strerror(errno)
+                  << std::endl;
+        return false;
+      }
+      buf += n;
+      len -= (size_t)n;
+    }
+    return true;
+  }
+
+  // Nhận đúng len byte (TCP)
+  inline bool recv_exact(uint8_t *buf, size_t len) {
+    while (len > 0) {
+      ssize_t n = ::recv(fd_, buf, len, 0);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        std::cerr << "Failed to receive SLMP frame: "
+                  << (n == 0 ? "connection closed" : strerror(errno))
+                  << std::endl;
+        return false;
+      }
+      buf += n;
+      len -= (size_t)n;
+    }
+    return true;
+  }
+
+  // Nhận một datagram (UDP) trước deadline, trả về số byte hoặc -1 nếu
+  // lỗi/hết hạn
+  inline long recv_datagram(uint8_t                              *buf,
+                            size_t                                size,
+                            std::chrono::steady_clock::time_point deadline) {
+    while (true) {
+      auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+      pollfd pfd{};
+      pfd.fd     = fd_;
+      pfd.events = POLLIN;
+      int ready  = remaining.count() > 0
+                     ? ::poll(&pfd, 1, (int)remaining.count())
+                     : 0;
+      if (ready < 0 && errno == EINTR) {
+        continue;
+      }
+      if (ready == 0) {
+        std::cerr << "Timed out waiting for SLMP response" << std::endl;
+        return -1;
+      }
+      ssize_t n = ready > 0 ? ::recv(fd_, buf, size, 0) : -1;
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0) {
+        std::cerr << "Failed to receive SLMP frame: " << strerror(errno)
+                  << std::endl;
+      }
+      return (long)n;
+    }
+  }
+};
+
+}  // namespace plc_slmp
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test_slmp/device_address.hpp"
+#include "test_slmp/plc_client.hpp"
+#include "test_slmp/trace.hpp"
+#include "test_slmp/transfer_engine.hpp"
+
+namespace plc_slmp {
+
+// Một khối thanh ghi được đọc từ mọi PLC trong snapshot
+struct SnapshotBlock {
+  std::string addr;
+  int         num = 0;
+};
+
+// Kết quả của một PLC trong snapshot
+struct TargetSnapshot {
+  std::string                           name;
+  bool                                  ok = false;
+  std::vector<uint16_t>                 data;  // Các khối nối tiếp nhau
+  std::chrono::steady_clock::time_point send_time;
+  std::chrono::steady_clock::time_point receive_time;
+
+  inline double latency_us() const {
+    return std::chrono::duration<double, std::micro>(receive_time - send_time)
+      .count();
+  }
+};
+
+// Snapshot của mọi PLC tại cùng một tick
+struct Snapshot {
+  uint64_t                              cycle = 0;
+  std::chrono::system_clock::time_point tick;  // Thời điểm tick (wall clock)
+  std::vector<TargetSnapshot>           targets;
+  double   skew_us  = 0.0;  // Chênh lệch thời điểm gửi giữa các PLC
+  double   span_us  = 0.0;  // Từ lần gửi đầu tiên tới lần nhận cuối cùng
+  uint64_t overruns = 0;    // Số tick bị bỏ vì chu kỳ trước chạy quá giờ
+
+  inline bool ok() const {
+    return std::all_of(targets.begin(),
+                       targets.end(),
+                       [](const TargetSnapshot &t) { return t.ok; });
+  }
+};
+
+// Đọc cùng các khối thanh ghi từ nhiều PlcClient tại một tick chung. Mỗi PLC
+// có một worker thread riêng; tick được công bố trước kDispatchLead và mọi
+// worker cùng sleep_until tới tick rồi mới gửi, nên thời gian một snapshot
+// bằng PLC chậm nhất thay vì tổng RTT của các PLC.
+class SnapshotCoordinator {
+public:
+  using Callback = std::function<void(const Snapshot &)>;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  // Thời gian công bố tick trước để worker kịp thức dậy
+  static constexpr std::chrono::microseconds kDispatchLead{500};
+
+  struct Worker {
+    PlcClient             *plc = nullptr;
+    std::string            name;
+    TransferEngine         engine;
+    std::vector<RangeRead> ranges;
+    TargetSnapshot         result;
+    std::thread            thread;
+
+    Worker(PlcClient &client, std::string target_name, TransferParams params)
+      : plc(&client), name(std::move(target_name)), engine(client, params) {
+    }
+  };
+
+  std::vector<SnapshotBlock>           blocks_;
+  std::vector<size_t>                  offsets_;
+  size_t                               words_ = 0;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Đồng bộ coordinator với worker
+  std::mutex              mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  uint64_t                generation_ = 0;
+  size_t                  pending_    = 0;
+  Clock::time_point       tick_;
+  bool                    shutdown_ = false;
+
+  // Chỉ một snapshot tại một thời điểm
+  std::mutex snapshot_mutex_;
+  Snapshot   snapshot_;
+
+  // Chạy định kỳ
+  std::thread             ticker_;
+  std::atomic<bool>       running_{false};
+  std::mutex              ticker_mutex_;
+  std::condition_variable ticker_cv_;
+
+  // seen là generation_ lúc worker được tạo: worker chỉ tham gia các chu kỳ
+  // bắt đầu sau đó
+  inline void worker_loop(Worker &worker, uint64_t seen) {
+    trace_set_thread_name("snapshot " + worker.name);
+    while (true) {
+      Clock::time_point tick;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_cv_.wait(lock,
+                       [&]() { return shutdown_ || generation_ != seen; });
+        if (shutdown_) {
+          return;
+        }
+        seen = generation_;
+        tick = tick_;
+      }
+
+      std::this_thread::sleep_until(tick);
+      {
+        SLMP_TRACE_SCOPE("snapshot_read", "snapshot");
+        worker.result.send_time = Clock::now();
+        worker.result.ok        = worker.engine.read_ranges(
+          worker.ranges.data(), worker.ranges.size());
+        worker.result.receive_time = Clock::now();
+      }
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--pending_ == 0) {
+        done_cv_.notify_all();
+      }
+    }
+  }
+
+  // Cho mọi worker đọc tại tick rồi gom kết quả vào snapshot_.
+  // snapshot_mutex_ phải đang được giữ.
+  inline void run_cycle(Clock::time_point                     tick,
+                        std::chrono::system_clock::time_point wall_tick) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      tick_    = tick;
+      pending_ = workers_.size();
+      generation_++;
+      start_cv_.notify_all();
+      done_cv_.wait(lock, [this]() { return pending_ == 0; });
+    }
+
+    snapshot_.cycle++;
+    snapshot_.tick = wall_tick;
+    snapshot_.targets.resize(workers_.size());
+    Clock::time_point first_send, last_send, last_receive;
+    for (size_t i = 0; i < workers_.size(); i++) {
+      const TargetSnapshot &result = workers_[i]->result;
+      TargetSnapshot       &target = snapshot_.targets[i];
+      target.name                  = workers_[i]->name;
+      target.ok                    = result.ok;
+      target.data.assign(result.data.begin(), result.data.end());
+      target.send_time    = result.send_time;
+      target.receive_time = result.receive_time;
+      if (i == 0 || result.send_time < first_send) {
+        first_send = result.send_time;
+      }
+      if (i == 0 || result.send_time > last_send) {
+        last_send = result.send_time;
+      }
+      if (i == 0 || result.receive_time > last_receive) {
+        last_receive = result.receive_time;
+      }
+    }
+    snapshot_.skew_us =
+      std::chrono::duration<double, std::micro>(last_send - first_send).count();
+    snapshot_.span_us =
+      std::chrono::duration<double, std::micro>(last_receive - first_send)
+        .count();
+  }
+
+public:
+  explicit SnapshotCoordinator(std::vector<SnapshotBlock> blocks)
+    : blocks_(std::move(blocks)) {
+    for (const SnapshotBlock &block : blocks_) {
+      offsets_.push_back(words_);
+      words_ += block.num > 0 ? (size_t)block.num : 0;
+    }
+  }
+
+  SnapshotCoordinator(const SnapshotCoordinator &)            = delete;
+  SnapshotCoordinator &operator=(const SnapshotCoordinator &) = delete;
+
+  ~SnapshotCoordinator() {
+    stop();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      shutdown_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &worker : workers_) {
+      if (worker->thread.joinable()) {
+        worker->thread.join();
+      }
+    }
+  }
+
+  // Thêm một PLC (đã init_plc). Không gọi khi đang chạy start().
+  inline bool add_target(PlcClient         &plc,
+                         const std::string &name,
+                         TransferParams     params = {}) {
+    if (running_) {
+      std::cerr << "Cannot add snapshot target while running" << std::endl;
+      return false;
+    }
+    for (const SnapshotBlock &block : blocks_) {
+      if (!plc.is_valid_register_address(block.addr.c_str()) ||
+          block.num <= 0) {
+        std::cerr << "Invalid snapshot block: " << block.addr << " x "
+                  << block.num << std::endl;
+        return false;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    auto worker = std::make_unique<Worker>(plc, name, params);
+    worker->result.name = name;
+    worker->result.data.resize(words_);
+    for (size_t i = 0; i < blocks_.size(); i++) {
+      RangeRead range;
+      range.addr = blocks_[i].addr.c_str();
+      range.num  = blocks_[i].num;
+      range.data = worker->result.data.data() + offsets_[i];
+      worker->ranges.push_back(range);
+    }
+    // snapshot_mutex_ chặn run_cycle nên generation_ không đổi cho tới khi
+    // worker vào workers_
+    uint64_t seen;
+    {
+      std::lock_guard<std::mutex> sync(mutex_);
+      seen = generation_;
+    }
+    Worker *raw    = worker.get();
+    worker->thread =
+      std::thread([this, raw, seen]() { worker_loop(*raw, seen); });
+    workers_.push_back(std::move(worker));
+    return true;
+  }
+
+  // Vị trí của khối thứ i trong TargetSnapshot::data
+  inline size_t block_offset(size_t i) const {
+    return offsets_[i];
+  }
+
+  inline size_t target_count() const {
+    return workers_.size();
+  }
+
+  // Chụp một snapshot ngay bây giờ. Trả về false nếu có PLC đọc lỗi; các PLC
+  // đọc được vẫn có dữ liệu trong out.
+  inline bool snapshot(Snapshot &out) {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    if (workers_.empty()) {
+      std::cerr << "No snapshot targets" << std::endl;
+      return false;
+    }
+    run_cycle(Clock::now() + kDispatchLead,
+              std::chrono::system_clock::now() + kDispatchLead);
+    out = snapshot_;
+    return out.ok();
+  }
+
+  // Chụp snapshot định kỳ tại các tick căn theo period của wall clock (ví dụ
+  // period 100 ms thì tick tại .000, .100, ...) và gọi callback sau mỗi
+  // snapshot từ thread nền. Tick bị lỡ do chu kỳ trước quá giờ thì bỏ qua.
+  inline void start(std::chrono::milliseconds period, Callback callback) {
+    if (period.count() <= 0 || running_.exchange(true)) {
+      return;
+    }
+    ticker_ = std::thread([this, period, callback]() {
+      using SysClock = std::chrono::system_clock;
+      auto sys_now   = SysClock::now();
+      auto wall_tick = SysClock::time_point(
+        (sys_now.time_since_epoch() / period + 1) * period);
+      auto tick = Clock::now() + (wall_tick - sys_now);
+
+      while (running_) {
+        {
+          std::unique_lock<std::mutex> lock(ticker_mutex_);
+          if (ticker_cv_.wait_until(lock, tick - kDispatchLead, [this]() {
+                return !running_;
+              })) {
+            break;
+          }
+        }
+
+        {
+          std::lock_guard<std::mutex> lock(snapshot_mutex_);
+          run_cycle(tick, wall_tick);
+          if (callback) {
+            SLMP_TRACE_SCOPE("snapshot_callback", "snapshot");
+            callback(snapshot_);
+          }
+        }
+
+        tick += period;
+        wall_tick += period;
+        auto now = Clock::now();
+        if (tick - kDispatchLead < now) {
+          auto missed = (now - (tick - kDispatchLead)) / period + 1;
+          tick += missed * period;
+          wall_tick += missed * period;
+          std::lock_guard<std::mutex> lock(snapshot_mutex_);
+          snapshot_.overruns += (uint64_t)missed;
+        }
+      }
+    });
+  }
+
+  inline void stop() {
+    {
+      std::lock_guard<std::mutex> lock(ticker_mutex_);
+      if (!running_.exchange(false)) {
+        return;
+      }
+    }
+    ticker_cv_.notify_all();
+    if (ticker_.joinable()) {
+      ticker_.join();
+    }
+  }
+};
+
+}  // namespace plc_slmp
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "test_slmp/device_address.hpp"
+#include "test_slmp/plc_client.hpp"
+
+namespace plc_slmp {
+
+// Cách đọc một kiểu giá trị từ các word của PLC. Giá trị 32 bit lưu word
+// thấp trước (D100 = 16 bit thấp, D101 = 16 bit cao).
+template <typename T>
+struct TagTraits;
+
+template <>
+struct TagTraits<bool> {
+  static constexpr int  kWords = 1;
+  static constexpr bool kBit   = true;
+  static bool decode(const uint16_t *words, int bit) {
+    return ((words[0] >> bit) & 1) != 0;
+  }
+};
+
+template <>
+struct TagTraits<uint16_t> {
+  static constexpr int  kWords = 1;
+  static constexpr bool kBit   = false;
+  static uint16_t decode(const uint16_t *words, int) {
+    return words[0];
+  }
+};
+
+template <>
+struct TagTraits<int16_t> {
+  static constexpr int  kWords = 1;
+  static constexpr bool kBit   = false;
+  static int16_t decode(const uint16_t *words, int) {
+    return (int16_t)words[0];
+  }
+};
+
+template <>
+struct TagTraits<uint32_t> {
+  static constexpr int  kWords = 2;
+  static constexpr bool kBit   = false;
+  static uint32_t decode(const uint16_t *words, int) {
+    return (uint32_t)words[0] | ((uint32_t)words[1] << 16);
+  }
+};
+
+template <>
+struct TagTraits<int32_t> {
+  static constexpr int  kWords = 2;
+  static constexpr bool kBit   = false;
+  static int32_t decode(const uint16_t *words, int bit) {
+    return (int32_t)TagTraits<uint32_t>::decode(words, bit);
+  }
+};
+
+template <>
+struct TagTraits<float> {
+  static constexpr int  kWords = 2;
+  static constexpr bool kBit   = false;
+  static float decode(const uint16_t *words, int bit) {
+    uint32_t raw = TagTraits<uint32_t>::decode(words, bit);
+    float    value;
+    memcpy(&value, &raw, sizeof(value));
+    return value;
+  }
+};
+
+// Khai báo một tag: địa chỉ PLC và tên. Địa chỉ được kiểm tra lúc compile
+// time khi Tag nằm trong một biểu thức constexpr; địa chỉ sai làm biên dịch
+// thất bại.
+template <typename T>
+struct Tag {
+  DeviceAddress address;
+  const char   *name;
+
+  constexpr Tag(const char *addr, const char *tag_name)
+    : address(checked_address(addr)), name(tag_name) {
+  }
+
+private:
+  static constexpr DeviceAddress checked_address(const char *addr) {
+    DeviceAddress result = parse_device_address(addr);
+    if (!result.valid()) {
+      throw std::invalid_argument("Invalid register address format");
+    }
+    if (TagTraits<T>::kBit != is_bit_device(result.type)) {
+      throw std::invalid_argument(
+        "bool tags need a bit device, numeric tags need a word device");
+    }
+    if (result.number + TagTraits<T>::kWords - 1 > kMaxDeviceNumber) {
+      throw std::invalid_argument("Tag exceeds the device range");
+    }
+    return result;
+  }
+};
+
+// Bảng tag khai báo lúc compile time, ví dụ:
+//
+//   constexpr TagMap map{Tag<int32_t>("D100", "speed"),
+//                        Tag<bool>("M5", "run")};
+//
+// Constructor constexpr sắp xếp các tag theo địa chỉ và gộp tag cùng loại
+// thiết bị thành các khối không quá kMaxBatchWords word, nên read() dùng số
+// frame ít nhất có thể. Mọi chuỗi địa chỉ của frame đều được tạo sẵn lúc
+// compile time, read() không parse gì lúc chạy.
+template <typename... Ts>
+class TagMap {
+public:
+  static constexpr size_t kSize = sizeof...(Ts);
+  using Values                  = std::tuple<Ts...>;
+
+  static_assert(kSize > 0, "TagMap needs at least one tag");
+
+  constexpr TagMap(const Tag<Ts> &...tags)
+    : infos_{TagInfo{tags.address, TagTraits<Ts>::kWords, tags.name}...} {
+    check_names();
+    check_overlaps();
+    build_plan();
+  }
+
+  // Số frame cần để đọc toàn bộ bảng
+  constexpr size_t frame_count() const {
+    return frame_count_;
+  }
+
+  // Số word của buffer trung gian khi đọc toàn bộ bảng
+  constexpr size_t word_count() const {
+    return word_count_;
+  }
+
+  // Vị trí của tag trong Values, dùng với std::get<map.index_of("speed")>
+  constexpr size_t index_of(const char *name) const {
+    for (size_t i = 0; i < kSize; i++) {
+      if (same_name(infos_[i].name, name)) {
+        return i;
+      }
+    }
+    throw std::invalid_argument("Unknown tag name");
+  }
+
+  constexpr const WordChunk &frame(size_t i) const {
+    return chunks_[i];
+  }
+
+  // Đọc toàn bộ bảng vào values, buffer phải có ít nhất word_count() word
+  inline bool read(PlcClient &plc, Values &values, uint16_t *buffer) const {
+    if (!plc.read_chunks(chunks_.data(), frame_count_, buffer)) {
+      return false;
+    }
+    decode(values, buffer);
+    return true;
+  }
+
+  // Tách giá trị các tag từ buffer đã đọc theo frame(0..frame_count())
+  inline void decode(Values &values, const uint16_t *buffer) const {
+    decode_all(values, buffer, std::index_sequence_for<Ts...>{});
+  }
+
+  // Như trên nhưng lấy buffer từ pool của plc, chỉ cấp phát trên heap khi
+  // word_count() vượt quá một slab
+  inline bool read(PlcClient &plc, Values &values) const {
+    PooledBuffer buffer = plc.acquire_buffer(word_count_ * sizeof(uint16_t));
+    if (!buffer) {
+      return false;
+    }
+    return read(plc, values, buffer.words());
+  }
+
+private:
+  struct TagInfo {
+    DeviceAddress address;
+    int           words;
+    const char   *name;
+  };
+
+  // Vị trí của tag trong buffer trung gian
+  struct Slot {
+    size_t offset = 0;
+    int    bit    = 0;
+  };
+
+  std::array<TagInfo, kSize>   infos_;
+  std::array<Slot, kSize>      slots_{};
+  std::array<WordChunk, kSize> chunks_{};
+  size_t                       frame_count_ = 0;
+  size_t                       word_count_  = 0;
+
+  static constexpr bool same_name(const char *a, const char *b) {
+    while (*a != '\0' && *a == *b) {
+      a++;
+      b++;
+    }
+    return *a == *b;
+  }
+
+  // Word đầu tiên của tag khi đọc theo đơn vị word
+  static constexpr uint32_t first_word(const TagInfo &info) {
+    return info.address.number / points_per_word(info.address.type);
+  }
+
+  constexpr void check_names() const {
+    for (size_t i = 0; i < kSize; i++) {
+      for (size_t j = i + 1; j < kSize; j++) {
+        if (same_name(infos_[i].name, infos_[j].name)) {
+          throw std::invalid_argument("Duplicate tag name");
+        }
+      }
+    }
+  }
+
+  // Hai tag không được dùng chung thanh ghi: tag word không được chồng lên
+  // nhau, tag bit không được trùng điểm
+  constexpr void check_overlaps() const {
+    for (size_t i = 0; i < kSize; i++) {
+      for (size_t j = i + 1; j < kSize; j++) {
+        const TagInfo &a = infos_[i];
+        const TagInfo &b = infos_[j];
+        if (a.address.type != b.address.type) {
+          continue;
+        }
+        const uint32_t a_end = a.address.number + (uint32_t)a.words;
+        const uint32_t b_end = b.address.number + (uint32_t)b.words;
+        const bool     overlap =
+          is_bit_device(a.address.type)
+                ? a.address.number == b.address.number
+                : a.address.number < b_end && b.address.number < a_end;
+        if (overlap) {
+          throw std::invalid_argument("Overlapping tags");
+        }
+      }
+    }
+  }
+
+  constexpr void build_plan() {
+    // Sắp xếp chỉ số tag theo (loại thiết bị, word đầu tiên)
+    std::array<size_t, kSize> order{};
+    for (size_t i = 0; i < kSize; i++) {
+      order[i] = i;
+    }
+    for (size_t i = 1; i < kSize; i++) {
+      size_t key = order[i];
+      size_t j   = i;
+      while (j > 0 && less(infos_[key], infos_[order[j - 1]])) {
+        order[j] = order[j - 1];
+        j--;
+      }
+      order[j] = key;
+    }
+
+    // Gộp tham lam: khối hiện tại nhận thêm tag nếu vẫn vừa một frame
+    RegisterType type  = RegisterType::UNKNOWN;
+    uint32_t     start = 0;
+    uint32_t     end   = 0;
+    for (size_t k = 0; k < kSize; k++) {
+      const TagInfo &info     = infos_[order[k]];
+      uint32_t       tag_from = first_word(info);
+      uint32_t       tag_to   = tag_from + (uint32_t)info.words;
+      if (frame_count_ == 0 || info.address.type != type ||
+          tag_to - start > (uint32_t)kMaxBatchWords) {
+        if (frame_count_ > 0) {
+          close_frame(type, start, end);
+        }
+        frame_count_++;
+        type  = info.address.type;
+        start = tag_from;
+        end   = tag_to;
+      } else if (tag_to > end) {
+        end = tag_to;
+      }
+
+      Slot &slot  = slots_[order[k]];
+      slot.offset = word_count_ + (tag_from - start);
+      slot.bit    = is_bit_device(type) ? (int)(info.address.number % 16) : 0;
+    }
+    close_frame(type, start, end);
+  }
+
+  static constexpr bool less(const TagInfo &a, const TagInfo &b) {
+    if (a.address.type != b.address.type) {
+      return a.address.type < b.address.type;
+    }
+    return first_word(a) < first_word(b);
+  }
+
+  // Hoàn tất frame cuối cùng đã mở (frame_count_ - 1)
+  constexpr void close_frame(RegisterType type, uint32_t start, uint32_t end) {
+    WordChunk    &chunk = chunks_[frame_count_ - 1];
+    DeviceAddress addr{type, start * points_per_word(type)};
+    format_device_address(addr, chunk.addr, sizeof(chunk.addr));
+    chunk.num    = (int)(end - start);
+    chunk.offset = word_count_;
+    word_count_ += end - start;
+  }
+
+  template <size_t... Is>
+  inline void decode_all(Values         &values,
+                         const uint16_t *buffer,
+                         std::index_sequence<Is...>) const {
+    ((std::get<Is>(values) =
+        TagTraits<std::tuple_element_t<Is, Values>>::decode(
+          buffer + slots_[Is].offset, slots_[Is].bit)),
+     ...);
+  }
+};
+
+}  // namespace plc_slmp
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Trace các bước trên hot path (chờ mutex, encode, network, decode, ...)
+// vào ring buffer riêng của từng thread rồi xuất ra JSON trace-event của
+// Chrome (mở bằng chrome://tracing hoặc ui.perfetto.dev). Bật bằng
+// -DTEST_SLMP_ENABLE_TRACE=1 (option CMake TEST_SLMP_ENABLE_TRACE). Khi
+// tắt, mọi macro SLMP_TRACE_* không sinh ra code nào.
+#ifndef TEST_SLMP_ENABLE_TRACE
+#define TEST_SLMP_ENABLE_TRACE 0
+#endif
+
+// Số event giữ lại trong ring buffer của mỗi thread (lũy thừa của 2)
+#ifndef TEST_SLMP_TRACE_RING_SIZE
+#define TEST_SLMP_TRACE_RING_SIZE 16384
+#endif
+
+#if TEST_SLMP_ENABLE_TRACE
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+namespace plc_slmp {
+
+static_assert((TEST_SLMP_TRACE_RING_SIZE & (TEST_SLMP_TRACE_RING_SIZE - 1)) ==
+                0,
+              "TEST_SLMP_TRACE_RING_SIZE must be a power of two");
+
+// Một khoảng thời gian đã đo. name và category phải là chuỗi hằng.
+struct TraceEvent {
+  const char *name     = nullptr;
+  const char *category = nullptr;
+  int64_t     begin_ns = 0;
+  int64_t     end_ns   = 0;
+  int64_t     arg      = -1;  // Số word (nếu có), âm nếu không dùng
+};
+
+inline int64_t trace_now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+// Ring buffer của một thread. Chỉ thread sở hữu ghi; dumper đọc từ thread
+// khác và bỏ các event có thể đã bị ghi đè trong lúc copy.
+class TraceRing {
+private:
+  static constexpr uint64_t kMask = TEST_SLMP_TRACE_RING_SIZE - 1;
+
+  std::unique_ptr<TraceEvent[]> events_;
+  std::atomic<uint64_t>         head_{0};
+  uint32_t                      tid_;
+  std::string                   thread_name_;
+  std::mutex                    name_mutex_;
+
+public:
+  explicit TraceRing(uint32_t tid)
+    : events_(new TraceEvent[TEST_SLMP_TRACE_RING_SIZE]), tid_(tid) {
+  }
+
+  inline void push(const TraceEvent &event) {
+    uint64_t head          = head_.load(std::memory_order_relaxed);
+    events_[head & kMask]  = event;
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  inline void copy_to(std::vector<TraceEvent> &out) const {
+    uint64_t head  = head_.load(std::memory_order_acquire);
+    uint64_t first = head > kMask + 1 ? head - (kMask + 1) : 0;
+    size_t   start = out.size();
+    for (uint64_t i = first; i < head; i++) {
+      out.push_back(events_[i & kMask]);
+    }
+    // Event có index < head_mới - kích thước ring có thể đã bị ghi đè
+    uint64_t after = head_.load(std::memory_order_acquire);
+    uint64_t valid = after > kMask + 1 ? after - (kMask + 1) : 0;
+    if (valid > first) {
+      size_t drop = (size_t)std::min<uint64_t>(valid - first, head - first);
+      out.erase(out.begin() + start, out.begin() + start + drop);
+    }
+  }
+
+  inline void clear() {
+    head_.store(0, std::memory_order_release);
+  }
+
+  inline uint32_t tid() const {
+    return tid_;
+  }
+
+  inline void set_thread_name(const std::string &name) {
+    std::lock_guard<std::mutex> lock(name_mutex_);
+    thread_name_ = name;
+  }
+
+  inline std::string thread_name() {
+    std::lock_guard<std::mutex> lock(name_mutex_);
+    return thread_name_;
+  }
+};
+
+// Danh sách ring buffer của mọi thread đã từng trace. Ring được giữ lại cả
+// sau khi thread kết thúc để vẫn xuất được.
+class TraceRegistry {
+private:
+  std::mutex                              mutex_;
+  std::vector<std::shared_ptr<TraceRing>> rings_;
+  int64_t                                 epoch_ns_ = trace_now_ns();
+
+public:
+  static inline TraceRegistry &instance() {
+    static TraceRegistry registry;
+    return registry;
+  }
+
+  inline TraceRing &ring_for_this_thread() {
+    thread_local std::shared_ptr<TraceRing> ring = [this]() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      rings_.push_back(std::make_shared<TraceRing>((uint32_t)rings_.size()));
+      return rings_.back();
+    }();
+    return *ring;
+  }
+
+  inline std::vector<std::shared_ptr<TraceRing>> rings() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rings_;
+  }
+
+  inline int64_t epoch_ns() const {
+    return epoch_ns_;
+  }
+};
+
+inline void trace_record(const char *name,
+                         const char *category,
+                         int64_t     begin_ns,
+                         int64_t     arg = -1) {
+  TraceEvent event;
+  event.name     = name;
+  event.category = category;
+  event.begin_ns = begin_ns;
+  event.end_ns   = trace_now_ns();
+  event.arg      = arg;
+  TraceRegistry::instance().ring_for_this_thread().push(event);
+}
+
+// Ghi một event từ lúc tạo tới lúc hủy
+class TraceScope {
+private:
+  const char *name_;
+  const char *category_;
+  int64_t     begin_ns_;
+  int64_t     arg_;
+
+public:
+  TraceScope(const char *name, const char *category, int64_t arg = -1)
+    : name_(name), category_(category), begin_ns_(trace_now_ns()), arg_(arg) {
+  }
+
+  TraceScope(const TraceScope &)            = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+  ~TraceScope() {
+    trace_record(name_, category_, begin_ns_, arg_);
+  }
+};
+
+// Tên hiển thị của thread hiện tại trong trace
+inline void trace_set_thread_name(const std::string &name) {
+  TraceRegistry::instance().ring_for_this_thread().set_thread_name(name);
+}
+
+// Xóa mọi event đã ghi. Chỉ gọi khi không có thread nào đang trace.
+inline void trace_clear() {
+  for (auto &ring : TraceRegistry::instance().rings()) {
+    ring->clear();
+  }
+}
+
+inline void trace_write_json_string(FILE *file, const std::string &text) {
+  fputc('"', file);
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      fputc('\\', file);
+      fputc(c, file);
+    } else if ((unsigned char)c < 0x20) {
+      fprintf(file, "\\u%04x", (unsigned)c);
+    } else {
+      fputc(c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+// Ghi mọi event đang có trong ring buffer ra file JSON trace-event của
+// Chrome. Gọi được khi các thread vẫn đang chạy.
+inline bool trace_dump_chrome(const std::string &path) {
+  FILE *file = fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    std::cerr << "Failed to open trace file: " << path << std::endl;
+    return false;
+  }
+
+  TraceRegistry          &registry = TraceRegistry::instance();
+  const int64_t           epoch    = registry.epoch_ns();
+  const int               pid      = (int)getpid();
+  std::vector<TraceEvent> events;
+  bool                    first = true;
+
+  fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  for (auto &ring : registry.rings()) {
+    std::string name = ring->thread_name();
+    if (name.empty()) {
+      name = "thread " + std::to_string(ring->tid());
+    }
+    fprintf(file,
+            "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+            "\"tid\":%u,\"args\":{\"name\":",
+            first ? "" : ",",
+            pid,
+            ring->tid());
+    trace_write_json_string(file, name);
+    fprintf(file, "}}");
+    first = false;
+
+    events.clear();
+    ring->copy_to(events);
+    for (const TraceEvent &e : events) {
+      if (e.name == nullptr) {
+        continue;
+      }
+      fprintf(file,
+              ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,"
+              "\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+              e.name,
+              e.category,
+              pid,
+              ring->tid(),
+              (e.begin_ns - epoch) / 1000.0,
+              (e.end_ns - e.begin_ns) / 1000.0);
+      if (e.arg >= 0) {
+        fprintf(file, ",\"args\":{\"words\":%lld}", (long long)e.arg);
+      }
+      fputc('}', file);
+    }
+  }
+  fprintf(file, "\n]}\n");
+  bool ok = ferror(file) == 0;
+  ok      = (fclose(file) == 0) && ok;
+  if (!ok) {
+    std::cerr << "Failed to write trace file: " << path << std::endl;
+  }
+  return ok;
+}
+
+}  // namespace plc_slmp
+
+#define SLMP_TRACE_CONCAT_(a, b) a##b
+#define SLMP_TRACE_CONCAT(a, b)  SLMP_TRACE_CONCAT_(a, b)
+
+// Đo tới hết scope hiện tại
+#define SLMP_TRACE_SCOPE(name, category)             \
+  ::plc_slmp::TraceScope SLMP_TRACE_CONCAT(          \
+    slmp_trace_scope_, __LINE__)(name, category)
+
+// Như SLMP_TRACE_SCOPE, kèm số word vào args của event
+#define SLMP_TRACE_SCOPE_WORDS(name, category, words) \
+  ::plc_slmp::TraceScope SLMP_TRACE_CONCAT(           \
+    slmp_trace_scope_, __LINE__)(name, category, (int64_t)(words))
+
+// Đo một đoạn không trùng với scope (ví dụ thời gian chờ lock_guard):
+// SLMP_TRACE_BEGIN(t); ...; SLMP_TRACE_END(t, "lock_wait", "plc");
+#define SLMP_TRACE_BEGIN(var) const int64_t var = ::plc_slmp::trace_now_ns()
+#define SLMP_TRACE_END(var, name, category) \
+  ::plc_slmp::trace_record(name, category, var)
+
+#else  // TEST_SLMP_ENABLE_TRACE
+
+namespace plc_slmp {
+
+inline void trace_set_thread_name(const std::string &) {
+}
+
+inline void trace_clear() {
+}
+
+// Trace đang tắt: không ghi file
+inline bool trace_dump_chrome(const std::string &) {
+  return false;
+}
+
+}  // namespace plc_slmp
+
+#define SLMP_TRACE_SCOPE(name, category)
+#define SLMP_TRACE_SCOPE_WORDS(name, category, words)
+#define SLMP_TRACE_BEGIN(var)
+#define SLMP_TRACE_END(var, name, category)
+
+#endif  // TEST_SLMP_ENABLE_TRACE
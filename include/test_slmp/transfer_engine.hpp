@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#include "test_slmp/device_address.hpp"
+#include "test_slmp/plc_client.hpp"
+#include "test_slmp/trace.hpp"
+
+namespace plc_slmp {
+
+// Tham số chia frame của TransferEngine
+struct TransferParams {
+  int max_frame_words = kMaxBatchWords;  // Số word tối đa trong một frame
+  int coalesce_gap    = 0;  // Khoảng trống (word) tối đa để gộp hai vùng
+  int pipeline_depth  = 1;  // Số frame gửi trước khi chờ phản hồi (native)
+};
+
+// Một vùng cần đọc trong read_ranges, kết quả ghi vào data[0..num)
+struct RangeRead {
+  const char *addr = nullptr;
+  int         num  = 0;
+  uint16_t   *data = nullptr;
+};
+
+// Đọc/ghi vùng thanh ghi tùy ý (ví dụ D0-D20000) bằng cách chia thành các
+// frame không vượt quá giới hạn của SLMP. Mỗi chunk được giải mã thẳng vào
+// đúng vị trí trong buffer của người gọi, toàn bộ vùng đi qua PlcClient
+// trong một lần giữ mutex. Với backend native, các chunk được pipeline theo
+// TransferParams::pipeline_depth.
+class TransferEngine {
+private:
+  // Vùng của read_ranges sau khi parse, span là vùng gộp chứa nó
+  struct RangeEntry {
+    DeviceAddress start;
+    int           num   = 0;
+    size_t        index = 0;
+    size_t        span  = 0;
+  };
+
+  // Vùng liên tục sau khi gộp, offset tính trong scratch_
+  struct Span {
+    DeviceAddress start;
+    int           num    = 0;
+    size_t        offset = 0;
+  };
+
+  PlcClient              &plc_;
+  TransferParams          params_;
+  std::vector<WordChunk>  chunks_;
+  std::vector<RangeEntry> entries_;
+  std::vector<Span>       spans_;
+  std::vector<uint16_t>   scratch_;
+  std::mutex              mutex_;
+
+  // Kiểm tra [start, start + num word) nằm trong dải số hiệu thiết bị
+  inline bool check_range(const char *addr, DeviceAddress start, int num) {
+    if (!start.valid()) {
+      std::cerr << "Invalid register address format: "
+                << (addr != nullptr ? addr : "(null)") << std::endl;
+      return false;
+    }
+    if (num <= 0) {
+      std::cerr << "Invalid transfer length: " << num << std::endl;
+      return false;
+    }
+
+    const uint64_t last =
+      start.number + (uint64_t)num * points_per_word(start.type) - 1;
+    if (last > kMaxDeviceNumber) {
+      std::cerr << "Transfer of " << num << " words from " << addr
+                << " exceeds the device range" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  // Chia [start, start + num word) thành các chunk nối vào chunks_, chunk
+  // đầu tiên ứng với vị trí offset trong buffer đích
+  inline void append_chunks(DeviceAddress start, int num, size_t offset) {
+    const uint32_t step        = points_per_word(start.type);
+    const int      frame_words = params_.max_frame_words;
+    for (int done = 0; done < num; done += frame_words) {
+      WordChunk     chunk;
+      DeviceAddress chunk_addr = start;
+      chunk_addr.number += (uint32_t)done * step;
+      format_device_address(chunk_addr, chunk.addr, sizeof(chunk.addr));
+      chunk.num    = std::min(frame_words, num - done);
+      chunk.offset = offset + (size_t)done;
+      chunks_.push_back(chunk);
+    }
+  }
+
+  // Chia [addr, addr + num word) thành các chunk, tái sử dụng chunks_
+  inline bool plan_chunks(const char *addr, int num) {
+    chunks_.clear();
+
+    DeviceAddress start = parse_device_address(addr);
+    if (!check_range(addr, start, num)) {
+      return false;
+    }
+    append_chunks(start, num, 0);
+    return true;
+  }
+
+  // Sắp xếp các vùng theo địa chỉ, gộp những vùng cùng loại thiết bị cách
+  // nhau không quá coalesce_gap word rồi chia các vùng gộp thành chunk
+  inline bool plan_ranges(const RangeRead *ranges, size_t count) {
+    entries_.clear();
+    spans_.clear();
+    chunks_.clear();
+
+    for (size_t i = 0; i < count; i++) {
+      RangeEntry entry;
+      entry.start = parse_device_address(ranges[i].addr);
+      entry.num   = ranges[i].num;
+      entry.index = i;
+      if (!check_range(ranges[i].addr, entry.start, entry.num)) {
+        return false;
+      }
+      entries_.push_back(entry);
+    }
+
+    std::sort(entries_.begin(),
+              entries_.end(),
+              [](const RangeEntry &a, const RangeEntry &b) {
+                if (a.start.type != b.start.type) {
+                  return a.start.type < b.start.type;
+                }
+                return a.start.number < b.start.number;
+              });
+
+    const uint64_t gap = (uint64_t)std::max(params_.coalesce_gap, 0);
+    for (RangeEntry &entry : entries_) {
+      const uint32_t step = points_per_word(entry.start.type);
+      if (!spans_.empty()) {
+        Span          &span = spans_.back();
+        const uint64_t span_end =
+          span.start.number + (uint64_t)span.num * step;
+        const uint32_t delta = entry.start.number - span.start.number;
+        // Thiết bị bit đọc theo word nên chỉ gộp được khi lệch bội số 16
+        if (span.start.type == entry.start.type && delta % step == 0 &&
+            entry.start.number <= span_end + gap * step) {
+          span.num   = std::max(span.num, (int)(delta / step) + entry.num);
+          entry.span = spans_.size() - 1;
+          continue;
+        }
+      }
+      Span span;
+      span.start = entry.start;
+      span.num   = entry.num;
+      spans_.push_back(span);
+      entry.span = spans_.size() - 1;
+    }
+
+    size_t total = 0;
+    for (Span &span : spans_) {
+      span.offset = total;
+      total += (size_t)span.num;
+      append_chunks(span.start, span.num, span.offset);
+    }
+    scratch_.resize(total);
+    return true;
+  }
+
+public:
+  explicit TransferEngine(PlcClient &plc, TransferParams params = {})
+    : plc_(plc) {
+    set_params(params);
+  }
+
+  inline void set_params(TransferParams params) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (params.max_frame_words <= 0 ||
+        params.max_frame_words > kMaxBatchWords) {
+      params.max_frame_words = kMaxBatchWords;
+    }
+    if (params.coalesce_gap < 0) {
+      params.coalesce_gap = 0;
+    }
+    params.pipeline_depth =
+      std::max(1, std::min(params.pipeline_depth, kMaxPipelineDepth));
+    params_ = params;
+  }
+
+  inline TransferParams params() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return params_;
+  }
+
+  // Đọc num word bắt đầu từ addr vào data[0..num)
+  inline bool read_range(const char *addr, int num, uint16_t *data) {
+    SLMP_TRACE_SCOPE_WORDS("read_range", "engine", num);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!plan_chunks(addr, num)) {
+      return false;
+    }
+    return plc_.read_chunks(
+      chunks_.data(), chunks_.size(), data, params_.pipeline_depth);
+  }
+
+  inline bool read_range(const char            *addr,
+                         int                    num,
+                         std::vector<uint16_t> &data) {
+    data.resize(num > 0 ? num : 0);
+    return read_range(addr, num, data.data());
+  }
+
+  // Đọc nhiều vùng rời rạc. Các vùng gần nhau được gộp thành một lần đọc
+  // theo TransferParams::coalesce_gap, sau đó tách lại vào buffer của từng
+  // vùng.
+  inline bool read_ranges(const RangeRead *ranges, size_t count) {
+    SLMP_TRACE_SCOPE("read_ranges", "engine");
+    std::lock_guard<std::mutex> lock(mutex_);
+    SLMP_TRACE_BEGIN(plan_begin);
+    if (!plan_ranges(ranges, count)) {
+      return false;
+    }
+    SLMP_TRACE_END(plan_begin, "plan_ranges", "engine");
+    if (!plc_.read_chunks(chunks_.data(),
+                          chunks_.size(),
+                          scratch_.data(),
+                          params_.pipeline_depth)) {
+      return false;
+    }
+
+    SLMP_TRACE_SCOPE_WORDS("scatter", "engine", scratch_.size());
+    for (const RangeEntry &entry : entries_) {
+      const Span    &span  = spans_[entry.span];
+      const uint32_t delta = (entry.start.number - span.start.number) /
+                             points_per_word(entry.start.type);
+      memcpy(ranges[entry.index].data,
+             scratch_.data() + span.offset + delta,
+             entry.num * sizeof(uint16_t));
+    }
+    return true;
+  }
+
+  // Ghi num word từ data[0..num) bắt đầu tại addr
+  inline bool write_range(const char *addr, int num, const uint16_t *data) {
+    SLMP_TRACE_SCOPE_WORDS("write_range", "engine", num);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!plan_chunks(addr, num)) {
+      return false;
+    }
+    return plc_.write_chunks(
+      chunks_.data(), chunks_.size(), data, params_.pipeline_depth);
+  }
+
+  inline bool write_range(const char                  *addr,
+                          int                          num,
+                          const std::vector<uint16_t> &data) {
+    if (num < 0 || data.size() < (size_t)num) {
+      std::cerr << "Data vector size (" << data.size()
+                << ") is smaller than requested write count (" << num << ")"
+                << std::endl;
+      return false;
+    }
+    return write_range(addr, num, data.data());
+  }
+};
+
+}  // namespace plc_slmp
@@ -36,6 +36,7 @@ int main(int, char **) {
   std::uniform_int_distribution<> dis(0, 1000);
 
   spdlog::info("Starting test_slmp");
+  plc_slmp::trace_set_thread_name("test_slmp");
 
   plc_slmp::PlcClient plc_client("192.168.6.10", 502, MELCLI_TYPE_TCPIP);
 
@@ -175,6 +176,27 @@ int main(int, char **) {
       data_match = false;
     }
 
+    // Test 5: Ghi và đọc lại D1-D100 trong một giao dịch
+    std::this_thread::sleep_for(100ms);
+
+    auto start_verify = std::chrono::high_resolution_clock::now();
+
+    std::vector<int> mismatch_offsets;
+    bool             verify_ok =
+      plc_client.write_and_verify("D1", 100, test_data, mismatch_offsets);
+
+    auto end_verify = std::chrono::high_resolution_clock::now();
+    auto duration_verify =
+      std::chrono::duration_cast<std::chrono::microseconds>(end_verify -
+                                                            start_verify);
+
+    for (int offset : mismatch_offsets) {
+      std::cout << "Verify mismatch at D" << (offset + 1) << "\n";
+    }
+    std::cout << "Write-and-verify (D1-D100): " << duration_verify.count()
+              << " microseconds, " << (verify_ok ? "PASSED" : "FAILED")
+              << "\n";
+
     // =================== HIỂN THỊ KẾT QUÀ MẪU ===================
     std::cout << "\n=== SAMPLE DATA (First 10 registers) ===\n";
     std::cout << "Register | Written | Sequential | Batch\n";
@@ -206,6 +228,9 @@ int main(int, char **) {
     std::cout << "  Batch:      " << duration_batch_read.count() << " μs\n";
     std::cout << "  Speedup:    " << read_improvement << "x\n\n";
 
+    std::cout << "Write-and-verify:\n";
+    std::cout << "  Time:       " << duration_verify.count() << " μs\n\n";
+
     std::cout << "Data integrity: " << (data_match ? "PASSED" : "FAILED")
               << "\n";
 
@@ -213,6 +238,11 @@ int main(int, char **) {
     logger->info("Write speedup: {}x, Read speedup: {}x",
                  write_improvement,
                  read_improvement);
+
+    // Chỉ ghi file khi build với TEST_SLMP_ENABLE_TRACE
+    if (plc_slmp::trace_dump_chrome("test_slmp_trace.json")) {
+      logger->info("Trace written to test_slmp_trace.json");
+    }
   }
   return 0;
 }
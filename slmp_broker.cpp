@@ -0,0 +1,121 @@
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <test_slmp/plc_client.hpp>
+#include <test_slmp/shm_broker.hpp>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace plc_slmp;
+
+static volatile std::sig_atomic_t g_stop = 0;
+
+void handle_signal(int) {
+  g_stop = 1;
+}
+
+void print_usage(const char *prog) {
+  spdlog::info("Usage: {} [--udp] [--native] [--image-mode <octal>] "
+               "[--queue-mode <octal>] <ip> <port> <name> <period_ms> "
+               "<block> [<block> ...]",
+               prog);
+  spdlog::info("  block: <address>:<words>, ví dụ D0:1000 M0:64");
+  spdlog::info("  --image-mode: quyền của image, mặc định 0644");
+  spdlog::info("  --queue-mode: quyền của hàng đợi ghi, mặc định 0600");
+}
+
+// Đọc quyền dạng bát phân ("0640"), trả về false nếu không hợp lệ
+bool parse_mode(const char *text, mode_t &mode) {
+  char *end   = nullptr;
+  long  value = strtol(text, &end, 8);
+  if (end == text || *end != '\0' || value < 0 || value > 0777) {
+    return false;
+  }
+  mode = (mode_t)value;
+  return true;
+}
+
+// Một tiến trình giữ kết nối PLC duy nhất và công bố image cho các tiến
+// trình khác qua shared memory (xem test_slmp/shm_client.hpp)
+int main(int argc, char **argv) {
+  int        type_protocol = MELCLI_TYPE_TCPIP;
+  PlcBackend backend       = PlcBackend::MELCLI;
+  mode_t     image_mode    = kShmImageMode;
+  mode_t     queue_mode    = kShmQueueMode;
+  std::vector<std::string> args;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--udp") == 0) {
+      type_protocol = MELCLI_TYPE_UDPIP;
+    } else if (strcmp(argv[i], "--native") == 0) {
+      backend = PlcBackend::NATIVE;
+    } else if (strcmp(argv[i], "--image-mode") == 0 ||
+               strcmp(argv[i], "--queue-mode") == 0) {
+      mode_t &mode = argv[i][2] == 'i' ? image_mode : queue_mode;
+      if (i + 1 >= argc || !parse_mode(argv[i + 1], mode)) {
+        spdlog::error("Invalid value for {}", argv[i]);
+        return 1;
+      }
+      i++;
+    } else {
+      args.push_back(argv[i]);
+    }
+  }
+  if (args.size() < 5) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string ip     = args[0];
+  int         port   = atoi(args[1].c_str());
+  std::string name   = args[2];
+  int         period = atoi(args[3].c_str());
+  std::vector<ShmBlockConfig> blocks;
+  for (size_t i = 4; i < args.size(); i++) {
+    size_t colon = args[i].find(':');
+    if (colon == std::string::npos) {
+      spdlog::error("Invalid block: {}", args[i]);
+      return 1;
+    }
+    blocks.push_back(
+      {args[i].substr(0, colon), atoi(args[i].c_str() + colon + 1)});
+  }
+  if (period <= 0) {
+    spdlog::error("Invalid period: {}", args[3]);
+    return 1;
+  }
+
+  PlcClient plc(ip, port, type_protocol);
+  plc.set_backend(backend);
+  if (!plc.init_plc()) {
+    spdlog::error("Failed to connect to PLC {}:{}", ip, port);
+    return 1;
+  }
+
+  ShmBroker broker(plc, name, blocks);
+  if (!broker.create(image_mode, queue_mode)) {
+    spdlog::error("Failed to create shared memory for {}", name);
+    return 1;
+  }
+
+  std::signal(SIGINT, handle_signal);
+  std::signal(SIGTERM, handle_signal);
+
+  spdlog::info("Publishing {} blocks from {}:{} as '{}' every {} ms",
+               blocks.size(),
+               ip,
+               port,
+               name,
+               period);
+  broker.start(std::chrono::milliseconds(period));
+  while (!g_stop) {
+    std::this_thread::sleep_for(100ms);
+  }
+  broker.stop();
+  plc.disconnect();
+  spdlog::info("Broker stopped after {} cycles", broker.cycle());
+  return 0;
+}
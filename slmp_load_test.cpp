@@ -0,0 +1,541 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <test_slmp/plc_client.hpp>
+#include <test_slmp/transfer_engine.hpp>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace plc_slmp;
+
+using Clock = std::chrono::steady_clock;
+
+static volatile std::sig_atomic_t g_stop = 0;
+
+void handle_signal(int) {
+  g_stop = 1;
+}
+
+// Các loại request trong tải
+enum OpKind { OP_READ = 0, OP_WRITE, OP_SCATTERED, OP_KINDS };
+
+const char *op_name(int kind) {
+  static const char *names[] = {"read", "write", "scattered"};
+  return names[kind];
+}
+
+// Histogram độ trễ (µs) log-linear: 16 bucket con cho mỗi lũy thừa của 2,
+// sai số tương đối không quá 1/16
+struct LatencyHistogram {
+  static constexpr int kSub     = 16;
+  static constexpr int kBuckets = 61 * kSub;
+
+  std::array<uint64_t, kBuckets> counts{};
+  uint64_t                       total  = 0;
+  uint64_t                       max_us = 0;
+
+  static int index(uint64_t us) {
+    if (us < (uint64_t)kSub) {
+      return (int)us;
+    }
+    const int shift = 63 - __builtin_clzll(us) - 4;
+    return (shift + 1) * kSub + (int)((us >> shift) & (kSub - 1));
+  }
+
+  // Cận trên của bucket
+  static uint64_t upper(int index) {
+    if (index < kSub) {
+      return (uint64_t)index;
+    }
+    const int shift = index / kSub - 1;
+    return (((uint64_t)(kSub + index % kSub) + 1) << shift) - 1;
+  }
+
+  void record(uint64_t us) {
+    counts[index(us)]++;
+    total++;
+    max_us = std::max(max_us, us);
+  }
+
+  void merge(const LatencyHistogram &other) {
+    for (int i = 0; i < kBuckets; i++) {
+      counts[i] += other.counts[i];
+    }
+    total += other.total;
+    max_us = std::max(max_us, other.max_us);
+  }
+
+  uint64_t percentile(double p) const {
+    if (total == 0) {
+      return 0;
+    }
+    const uint64_t rank = std::max<uint64_t>(1, (uint64_t)(p / 100.0 * total));
+    uint64_t       seen = 0;
+    for (int i = 0; i < kBuckets; i++) {
+      seen += counts[i];
+      if (seen >= rank) {
+        return std::min(upper(i), max_us);
+      }
+    }
+    return max_us;
+  }
+};
+
+// Số liệu của một khoảng thời gian, theo loại request
+struct WindowStats {
+  LatencyHistogram latency[OP_KINDS];
+  uint64_t         errors[OP_KINDS] = {};
+
+  void merge(const WindowStats &other) {
+    for (int k = 0; k < OP_KINDS; k++) {
+      latency[k].merge(other.latency[k]);
+      errors[k] += other.errors[k];
+    }
+  }
+
+  uint64_t ok() const {
+    uint64_t n = 0;
+    for (int k = 0; k < OP_KINDS; k++) {
+      n += latency[k].total;
+    }
+    return n;
+  }
+
+  uint64_t failed() const {
+    uint64_t n = 0;
+    for (int k = 0; k < OP_KINDS; k++) {
+      n += errors[k];
+    }
+    return n;
+  }
+
+  LatencyHistogram all() const {
+    LatencyHistogram h;
+    for (int k = 0; k < OP_KINDS; k++) {
+      h.merge(latency[k]);
+    }
+    return h;
+  }
+};
+
+// Số liệu của một thread tải, reporter lấy ra và xóa sau mỗi interval
+struct ThreadStats {
+  std::mutex  mutex;
+  WindowStats window;
+};
+
+struct LoadConfig {
+  std::string host          = "127.0.0.1";
+  int         port          = 5007;
+  int         type_protocol = MELCLI_TYPE_TCPIP;
+  PlcBackend  backend       = PlcBackend::MELCLI;
+  int         threads       = 8;
+  int         clients       = 1;
+  int         mix[OP_KINDS] = {70, 20, 10};  // Tỉ lệ read:write:scattered
+  int         words         = 100;   // Số word mỗi request read/write
+  int         groups        = 8;     // Số vùng mỗi request scattered
+  int         group_words   = 10;    // Số word mỗi vùng scattered
+  std::string base          = "D0";  // Đầu vùng thanh ghi dùng cho tải
+  int         span          = 10000;
+  double      rate          = 0.0;   // Tổng request/s, 0 là không giới hạn
+  bool        open_loop     = false;
+  double      duration      = 30.0;  // Giây
+  double      interval      = 1.0;   // Giây giữa hai dòng báo cáo
+  double      max_error_pct = 0.0;
+  std::string csv;
+};
+
+void print_usage(const char *prog) {
+  spdlog::info("Usage: {} [options]", prog);
+  spdlog::info("  --host <ip>            (default 127.0.0.1)");
+  spdlog::info("  --port <port>          (default 5007)");
+  spdlog::info("  --udp | --native       UDP / native SLMP backend");
+  spdlog::info("  --threads <n>          load threads (default 8)");
+  spdlog::info("  --clients <n>          PlcClient instances shared by the "
+               "threads round-robin (default 1)");
+  spdlog::info("  --mix <r:w:s>          read:write:scattered ratio "
+               "(default 70:20:10)");
+  spdlog::info("  --words <n>            words per read/write (default 100)");
+  spdlog::info("  --groups <n>x<words>   scattered groups (default 8x10)");
+  spdlog::info("  --base <addr>          first register (default D0)");
+  spdlog::info("  --span <words>         register range (default 10000)");
+  spdlog::info("  --rate <req/s>         total target rate (default: max)");
+  spdlog::info("  --open-loop            fixed arrival schedule, latency "
+               "from the intended send time");
+  spdlog::info("  --duration <s>         (default 30)");
+  spdlog::info("  --interval <s>         report interval (default 1)");
+  spdlog::info("  --max-error-pct <pct>  fail above this error rate "
+               "(default 0)");
+  spdlog::info("  --csv <file>           write one row per interval");
+}
+
+bool parse_args(int argc, char **argv, LoadConfig &config) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    if (strcmp(arg, "--udp") == 0) {
+      config.type_protocol = MELCLI_TYPE_UDPIP;
+      continue;
+    }
+    if (strcmp(arg, "--native") == 0) {
+      config.backend = PlcBackend::NATIVE;
+      continue;
+    }
+    if (strcmp(arg, "--open-loop") == 0) {
+      config.open_loop = true;
+      continue;
+    }
+
+    // Các option còn lại đều có giá trị
+    if (i + 1 >= argc) {
+      spdlog::error("Unknown option or missing value: {}", arg);
+      return false;
+    }
+    const char *value = argv[++i];
+    if (strcmp(arg, "--host") == 0) {
+      config.host = value;
+    } else if (strcmp(arg, "--port") == 0) {
+      config.port = atoi(value);
+    } else if (strcmp(arg, "--threads") == 0) {
+      config.threads = atoi(value);
+    } else if (strcmp(arg, "--clients") == 0) {
+      config.clients = atoi(value);
+    } else if (strcmp(arg, "--mix") == 0) {
+      if (sscanf(value,
+                 "%d:%d:%d",
+                 &config.mix[OP_READ],
+                 &config.mix[OP_WRITE],
+                 &config.mix[OP_SCATTERED]) != 3) {
+        spdlog::error("Invalid mix: {}", value);
+        return false;
+      }
+    } else if (strcmp(arg, "--words") == 0) {
+      config.words = atoi(value);
+    } else if (strcmp(arg, "--groups") == 0) {
+      if (sscanf(value, "%dx%d", &config.groups, &config.group_words) != 2) {
+        spdlog::error("Invalid groups: {}", value);
+        return false;
+      }
+    } else if (strcmp(arg, "--base") == 0) {
+      config.base = value;
+    } else if (strcmp(arg, "--span") == 0) {
+      config.span = atoi(value);
+    } else if (strcmp(arg, "--rate") == 0) {
+      config.rate = atof(value);
+    } else if (strcmp(arg, "--duration") == 0) {
+      config.duration = atof(value);
+    } else if (strcmp(arg, "--interval") == 0) {
+      config.interval = atof(value);
+    } else if (strcmp(arg, "--max-error-pct") == 0) {
+      config.max_error_pct = atof(value);
+    } else if (strcmp(arg, "--csv") == 0) {
+      config.csv = value;
+    } else {
+      spdlog::error("Unknown option: {}", arg);
+      return false;
+    }
+  }
+
+  const DeviceAddress base = parse_device_address(config.base.c_str());
+  const int mix_total = config.mix[0] + config.mix[1] + config.mix[2];
+  if (config.threads <= 0 || config.clients <= 0 || config.words <= 0 ||
+      config.words > kMaxBatchWords || config.groups <= 0 ||
+      config.group_words <= 0 || config.duration <= 0 ||
+      config.interval <= 0 || config.rate < 0 || mix_total <= 0 ||
+      config.mix[0] < 0 || config.mix[1] < 0 || config.mix[2] < 0) {
+    spdlog::error("Invalid arguments");
+    return false;
+  }
+  if (!base.valid() || is_bit_device(base.type) ||
+      config.span < std::max(config.words, config.group_words)) {
+    spdlog::error("Invalid register range: {} x {}",
+                  config.base,
+                  config.span);
+    return false;
+  }
+  if (config.open_loop && config.rate <= 0) {
+    spdlog::error("--open-loop needs --rate");
+    return false;
+  }
+  return true;
+}
+
+// Địa chỉ word thứ offset tính từ base
+std::string offset_address(DeviceAddress base, int offset) {
+  char buf[kMaxAddressLength];
+  base.number += (uint32_t)offset;
+  format_device_address(base, buf, sizeof(buf));
+  return buf;
+}
+
+// Vòng lặp của một thread tải. Với --rate, request thứ k của thread được lên
+// lịch tại start + (k + phase) * period. Closed loop: lịch bị trễ thì dời
+// lại, độ trễ đo từ lúc gửi. Open loop: giữ nguyên lịch, độ trễ đo từ thời
+// điểm lẽ ra phải gửi nên thời gian xếp hàng cũng được tính.
+void load_thread(const LoadConfig  &config,
+                 PlcClient         &plc,
+                 int                index,
+                 ThreadStats       &stats,
+                 Clock::time_point  start,
+                 Clock::time_point  end) {
+  const DeviceAddress base = parse_device_address(config.base.c_str());
+  TransferEngine      engine(plc);
+  std::mt19937        rng(12345u + (unsigned)index);
+  std::discrete_distribution<int> pick_op(std::begin(config.mix),
+                                          std::end(config.mix));
+  std::uniform_int_distribution<int> pick_offset(0,
+                                                 config.span - config.words);
+  std::uniform_int_distribution<int> pick_group(
+    0, config.span - config.group_words);
+
+  std::vector<uint16_t> data(config.words);
+  std::vector<uint16_t> scattered((size_t)config.groups * config.group_words);
+  std::vector<std::string> group_addr(config.groups);
+  std::vector<RangeRead>   ranges(config.groups);
+
+  const bool paced = config.rate > 0;
+  const auto period =
+    paced ? std::chrono::duration_cast<Clock::duration>(
+              std::chrono::duration<double>(config.threads / config.rate))
+          : Clock::duration::zero();
+  Clock::time_point next = start + period * index / config.threads;
+
+  while (!g_stop) {
+    if (paced) {
+      if (next >= end) {
+        break;
+      }
+      std::this_thread::sleep_until(next);
+    }
+    const Clock::time_point send = Clock::now();
+    if (send >= end) {
+      break;
+    }
+
+    const int kind = pick_op(rng);
+    bool      ok   = false;
+    if (kind == OP_READ) {
+      std::string addr = offset_address(base, pick_offset(rng));
+      ok               = plc.read_batch_d_registers(addr.c_str(),
+                                      config.words,
+                                      data);
+    } else if (kind == OP_WRITE) {
+      std::string addr = offset_address(base, pick_offset(rng));
+      for (int i = 0; i < config.words; i++) {
+        data[i] = (uint16_t)(rng() & 0xFFFF);
+      }
+      ok = plc.write_batch_d_registers(addr.c_str(), config.words, data);
+    } else {
+      for (int g = 0; g < config.groups; g++) {
+        group_addr[g]  = offset_address(base, pick_group(rng));
+        ranges[g].addr = group_addr[g].c_str();
+        ranges[g].num  = config.group_words;
+        ranges[g].data = scattered.data() + (size_t)g * config.group_words;
+      }
+      ok = engine.read_ranges(ranges.data(), ranges.size());
+    }
+    const Clock::time_point done = Clock::now();
+
+    const Clock::time_point from = config.open_loop ? next : send;
+    const uint64_t          us   = (uint64_t)
+      std::chrono::duration_cast<std::chrono::microseconds>(done - from)
+        .count();
+    {
+      std::lock_guard<std::mutex> lock(stats.mutex);
+      if (ok) {
+        stats.window.latency[kind].record(us);
+      } else {
+        stats.window.errors[kind]++;
+      }
+    }
+
+    if (paced) {
+      next += period;
+      if (!config.open_loop && next < done) {
+        next = done;
+      }
+    }
+  }
+}
+
+void log_window(const char        *label,
+                double             seconds,
+                const WindowStats &window) {
+  const LatencyHistogram all    = window.all();
+  const uint64_t         failed = window.failed();
+  const uint64_t         total  = all.total + failed;
+  spdlog::info("{:>8} {:>9.0f} req/s  err {:>6.2f}%  p50 {:>6} p90 {:>6} "
+               "p99 {:>6} p99.9 {:>6} max {:>7} us",
+               label,
+               all.total / seconds,
+               total > 0 ? 100.0 * failed / total : 0.0,
+               all.percentile(50),
+               all.percentile(90),
+               all.percentile(99),
+               all.percentile(99.9),
+               all.max_us);
+}
+
+// slmp_load_test: tạo tải đọc/ghi/scattered từ nhiều thread và nhiều
+// PlcClient lên một endpoint SLMP (mặc định simulator cục bộ), báo cáo
+// throughput, độ trễ đuôi và tỉ lệ lỗi theo thời gian.
+int main(int argc, char **argv) {
+  LoadConfig config;
+  if (!parse_args(argc, argv, config)) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<PlcClient>> clients;
+  for (int c = 0; c < config.clients; c++) {
+    clients.push_back(std::make_unique<PlcClient>(
+      config.host, config.port, config.type_protocol));
+    clients.back()->set_backend(config.backend);
+    if (!clients.back()->init_plc()) {
+      spdlog::error("Failed to connect to PLC {}:{}", config.host, config.port);
+      return 1;
+    }
+  }
+
+  std::ofstream csv;
+  if (!config.csv.empty()) {
+    csv.open(config.csv, std::ios::trunc);
+    if (!csv.is_open()) {
+      spdlog::error("Failed to open CSV file: {}", config.csv);
+      return 1;
+    }
+    csv << "Elapsed_s,Ok,Errors,Req_per_s,Error_pct,P50_us,P90_us,P99_us,"
+        << "P999_us,Max_us\n";
+  }
+
+  std::signal(SIGINT, handle_signal);
+  std::signal(SIGTERM, handle_signal);
+
+  spdlog::info("Load test against {}:{}: {} threads, {} clients, mix "
+               "{}:{}:{}, {} for {} s",
+               config.host,
+               config.port,
+               config.threads,
+               config.clients,
+               config.mix[OP_READ],
+               config.mix[OP_WRITE],
+               config.mix[OP_SCATTERED],
+               config.rate > 0
+                 ? fmt::format("{} req/s {}",
+                               config.rate,
+                               config.open_loop ? "open loop" : "closed loop")
+                 : std::string("max rate"),
+               config.duration);
+
+  std::vector<std::unique_ptr<ThreadStats>> stats;
+  std::vector<std::thread>                  workers;
+  const Clock::time_point                   start = Clock::now() + 10ms;
+  const Clock::time_point                   end =
+    start + std::chrono::duration_cast<Clock::duration>(
+              std::chrono::duration<double>(config.duration));
+  for (int t = 0; t < config.threads; t++) {
+    stats.push_back(std::make_unique<ThreadStats>());
+    workers.emplace_back(load_thread,
+                         std::cref(config),
+                         std::ref(*clients[t % config.clients]),
+                         t,
+                         std::ref(*stats.back()),
+                         start,
+                         end);
+  }
+
+  // Báo cáo mỗi interval cho tới khi mọi thread kết thúc
+  WindowStats       total;
+  Clock::time_point last = start;
+  const auto        step = std::chrono::duration_cast<Clock::duration>(
+    std::chrono::duration<double>(config.interval));
+  bool finished = false;
+  while (!finished) {
+    Clock::time_point wake = std::min(last + step, end);
+    while (!g_stop && Clock::now() < wake) {
+      std::this_thread::sleep_for(std::min<Clock::duration>(
+        wake - Clock::now(), std::chrono::milliseconds(100)));
+    }
+    finished = g_stop || Clock::now() >= end;
+    if (finished) {
+      for (auto &worker : workers) {
+        worker.join();
+      }
+    }
+
+    WindowStats window;
+    for (auto &s : stats) {
+      std::lock_guard<std::mutex> lock(s->mutex);
+      window.merge(s->window);
+      s->window = WindowStats();
+    }
+    const Clock::time_point now     = Clock::now();
+    const double            seconds =
+      std::max(1e-9, std::chrono::duration<double>(now - last).count());
+    const double elapsed = std::chrono::duration<double>(now - start).count();
+    last                 = now;
+    total.merge(window);
+
+    log_window(fmt::format("{:.1f}s", elapsed).c_str(), seconds, window);
+    if (csv.is_open()) {
+      const LatencyHistogram all    = window.all();
+      const uint64_t         failed = window.failed();
+      const uint64_t         n      = all.total + failed;
+      csv << elapsed << "," << all.total << "," << failed << ","
+          << all.total / seconds << "," << (n > 0 ? 100.0 * failed / n : 0.0)
+          << "," << all.percentile(50) << "," << all.percentile(90) << ","
+          << all.percentile(99) << "," << all.percentile(99.9) << ","
+          << all.max_us << "\n";
+    }
+  }
+
+  const double elapsed =
+    std::chrono::duration<double>(last - start).count();
+  spdlog::info("Summary over {:.1f} s:", elapsed);
+  log_window("total", elapsed, total);
+  for (int k = 0; k < OP_KINDS; k++) {
+    const LatencyHistogram &h = total.latency[k];
+    if (h.total + total.errors[k] == 0) {
+      continue;
+    }
+    spdlog::info("{:>9} {:>9} ok {:>7} errors  p50 {:>6} p99 {:>6} "
+                 "p99.9 {:>6} max {:>7} us",
+                 op_name(k),
+                 h.total,
+                 total.errors[k],
+                 h.percentile(50),
+                 h.percentile(99),
+                 h.percentile(99.9),
+                 h.max_us);
+  }
+
+  for (auto &client : clients) {
+    client->disconnect();
+  }
+
+  const uint64_t requests  = total.ok() + total.failed();
+  const double   error_pct =
+    requests > 0 ? 100.0 * total.failed() / requests : 0.0;
+  if (requests == 0) {
+    spdlog::error("No requests completed");
+    return 1;
+  }
+  if (error_pct > config.max_error_pct) {
+    spdlog::error("Error rate {:.3f}% exceeds {:.3f}%",
+                  error_pct,
+                  config.max_error_pct);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,120 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <test_slmp/plc_async.hpp>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace plc_slmp;
+
+// Thống kê chung của mọi chuỗi điều khiển
+struct SequenceStats {
+  std::atomic<long> cycles{0};
+  std::atomic<long> failures{0};
+  std::atomic<long> mismatches{0};
+};
+
+// Một chuỗi điều khiển: đọc bộ đếm -> quyết định -> ghi -> đọc lại kiểm tra,
+// rồi nghỉ. Viết tuần tự như code blocking nhưng chỉ tạm dừng coroutine.
+PlcTask<void> control_sequence(PlcEventLoop   &loop,
+                               AsyncPlcClient &plc,
+                               int             index,
+                               int             cycles,
+                               SequenceStats  &stats) {
+  std::string addr = "D" + std::to_string(2000 + index);
+
+  for (int cycle = 0; cycle < cycles; cycle++) {
+    uint16_t value = 0;
+    if (!co_await plc.read(addr.c_str(), value)) {
+      stats.failures++;
+      co_return;
+    }
+
+    uint16_t next = (value >= 60000) ? 0 : (uint16_t)(value + 1);
+    if (!co_await plc.write(addr.c_str(), next)) {
+      stats.failures++;
+      co_return;
+    }
+
+    uint16_t check = 0;
+    if (!co_await plc.read(addr.c_str(), check)) {
+      stats.failures++;
+      co_return;
+    }
+    if (check != next) {
+      stats.mismatches++;
+    }
+    stats.cycles++;
+
+    co_await loop.sleep_for(1ms);
+  }
+}
+
+// test_async_sequences [ip] [port] [sequences] [cycles] [threads]
+int main(int argc, char **argv) {
+  std::string ip        = argc > 1 ? argv[1] : "127.0.0.1";
+  int         port      = argc > 2 ? atoi(argv[2]) : 5007;
+  int         sequences = argc > 3 ? atoi(argv[3]) : 1000;
+  int         cycles    = argc > 4 ? atoi(argv[4]) : 10;
+  int         threads   = argc > 5 ? atoi(argv[5]) : 2;
+  if (sequences <= 0 || cycles <= 0 || threads <= 0) {
+    spdlog::error("Invalid arguments");
+    return 1;
+  }
+
+  spdlog::info("Running {} control sequences x {} cycles on {} threads "
+               "against {}:{}",
+               sequences,
+               cycles,
+               threads,
+               ip,
+               port);
+
+  // Mỗi thread có một event loop và một kết nối PLC riêng
+  SequenceStats            stats;
+  std::vector<std::thread> workers;
+  std::atomic<int>         connect_failures{0};
+  auto                     start = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&, t]() {
+      PlcEventLoop    loop;
+      SlmpFrameConfig frame;
+      frame.frame = SlmpFrameType::FRAME_4E;
+      AsyncPlcClient plc(loop, ip, port, MELCLI_TYPE_TCPIP, frame);
+      if (!plc.init_plc()) {
+        connect_failures++;
+        return;
+      }
+      for (int i = t; i < sequences; i += threads) {
+        loop.spawn(control_sequence(loop, plc, i, cycles, stats));
+      }
+      loop.run();
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  auto elapsed = std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
+  if (connect_failures > 0) {
+    spdlog::error("Failed to connect to PLC {}:{}", ip, port);
+    return 1;
+  }
+
+  long requests = stats.cycles * 3;
+  spdlog::info("Completed {} cycles ({} requests) in {:.3f} s: {:.0f} "
+               "requests/s",
+               stats.cycles.load(),
+               requests,
+               elapsed,
+               requests / elapsed);
+  spdlog::info("Failures: {}, read-back mismatches: {}",
+               stats.failures.load(),
+               stats.mismatches.load());
+  return (stats.failures == 0 && stats.mismatches == 0) ? 0 : 1;
+}
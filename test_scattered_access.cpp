@@ -8,7 +8,9 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 #include <sstream>
+#include <test_slmp/auto_tuner.hpp>
 #include <test_slmp/plc_client.hpp>
+#include <test_slmp/transfer_engine.hpp>
 #include <thread>
 #include <vector>
 
@@ -118,6 +120,21 @@ int main(int, char **) {
 
   logger->info("PLC connection established successfully");
 
+  // Engine tự chia vùng lớn thành các frame, tham số do AutoTuner đo
+  plc_slmp::TransferEngine transfer_engine(plc_client);
+  plc_slmp::AutoTuner      auto_tuner(plc_client, transfer_engine);
+  if (auto_tuner.tune()) {
+    plc_slmp::LatencyModel   model  = auto_tuner.model();
+    plc_slmp::TransferParams params = transfer_engine.params();
+    logger->info(
+      "Latency model: {:.1f}μs/frame + {:.3f}μs/word -> frame {} words, "
+      "coalesce gap {} words",
+      model.per_frame_us,
+      model.per_word_us,
+      params.max_frame_words,
+      params.coalesce_gap);
+  }
+
   // Định nghĩa 10 cụm thanh ghi (mỗi cụm 100 thanh ghi)
   std::vector<RegisterGroup> register_groups = {
     RegisterGroup(1, 100, "D1-D100"),      // Cụm 1
@@ -291,6 +308,29 @@ int main(int, char **) {
       std::chrono::duration_cast<std::chrono::microseconds>(
         end_sequential_read - start_sequential_read);
 
+    // =================== TEST ĐỌC BẰNG TRANSFER ENGINE ===================
+    std::cout << "\n=== TESTING TRANSFER ENGINE READ (D1-D1000) ===\n";
+
+    std::this_thread::sleep_for(100ms);
+
+    auto start_engine_read = std::chrono::high_resolution_clock::now();
+
+    std::vector<uint16_t> engine_read_data;
+    if (!transfer_engine.read_range("D1", 1000, engine_read_data)) {
+      logger->error("Failed to read D1-D1000 with transfer engine");
+    }
+
+    auto end_engine_read = std::chrono::high_resolution_clock::now();
+    auto duration_engine_read =
+      std::chrono::duration_cast<std::chrono::microseconds>(end_engine_read -
+                                                            start_engine_read);
+
+    std::cout << "Transfer engine read (D1-D1000): "
+              << duration_engine_read.count() << " μs, "
+              << (engine_read_data == sequential_read_data ? "matches"
+                                                           : "differs from")
+              << " sequential read\n";
+
     // =================== HIỂN THỊ KẾT QUẢ MẪU ===================
     std::cout << "\n=== SAMPLE DATA (First 10 registers from each scattered "
                  "group) ===\n";
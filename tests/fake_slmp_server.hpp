@@ -0,0 +1,266 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "test_slmp/device_address.hpp"
+
+// PLC giả cho test: server SLMP 3E binary qua TCP trên 127.0.0.1 (cổng do
+// hệ điều hành chọn), chỉ hỗ trợ batch read/write theo word. Mỗi kết nối
+// được phục vụ bởi một thread riêng. Dùng với PlcClient backend NATIVE:
+//
+//   FakeSlmpServer server;
+//   PlcClient plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+//   plc.set_backend(PlcBackend::NATIVE);
+//   plc.init_plc();
+class FakeSlmpServer {
+public:
+  // Gọi trong thread của server trước khi trả response, có thể chặn để
+  // giữ response lại
+  using Hook =
+    std::function<void(const plc_slmp::DeviceAddress &, int num, bool write)>;
+
+  FakeSlmpServer() {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port        = 0;
+    socklen_t len        = sizeof(addr);
+    if (listen_fd_ < 0 ||
+        ::bind(listen_fd_, (sockaddr *)&addr, sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 16) != 0 ||
+        ::getsockname(listen_fd_, (sockaddr *)&addr, &len) != 0) {
+      return;
+    }
+    port_   = ntohs(addr.sin_port);
+    accept_ = std::thread([this]() { accept_loop(); });
+  }
+
+  FakeSlmpServer(const FakeSlmpServer &)            = delete;
+  FakeSlmpServer &operator=(const FakeSlmpServer &) = delete;
+
+  ~FakeSlmpServer() {
+    stopping_ = true;
+    ::shutdown(listen_fd_, SHUT_RDWR);
+    if (accept_.joinable()) {
+      accept_.join();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (int fd : clients_) {
+        ::shutdown(fd, SHUT_RDWR);
+      }
+    }
+    for (std::thread &t : workers_) {
+      t.join();
+    }
+    ::close(listen_fd_);
+  }
+
+  int port() const {
+    return port_;
+  }
+
+  void set_hook(Hook hook) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hook_ = std::move(hook);
+  }
+
+  void set(const char *addr, uint16_t value) {
+    plc_slmp::DeviceAddress a = plc_slmp::parse_device_address(addr);
+    std::lock_guard<std::mutex> lock(mutex_);
+    memory(a.type)[word_index(a)] = value;
+  }
+
+  uint16_t get(const char *addr) {
+    plc_slmp::DeviceAddress a = plc_slmp::parse_device_address(addr);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memory(a.type)[word_index(a)];
+  }
+
+  uint64_t reads() const {
+    return reads_;
+  }
+
+  uint64_t writes() const {
+    return writes_;
+  }
+
+  // Số response được gửi khi request kế tiếp trên cùng kết nối đã tới, tức
+  // client gửi request đó mà không chờ response trước (pipeline)
+  uint64_t pipelined() const {
+    return pipelined_;
+  }
+
+private:
+  static constexpr size_t kHeader = 9;  // Tới hết trường request length
+
+  int                                  listen_fd_ = -1;
+  int                                  port_      = 0;
+  std::atomic<bool>                    stopping_{false};
+  std::atomic<uint64_t>                reads_{0};
+  std::atomic<uint64_t>                writes_{0};
+  std::atomic<uint64_t>                pipelined_{0};
+  std::thread                          accept_;
+  std::vector<std::thread>             workers_;
+  std::vector<int>                     clients_;
+  std::map<int, std::vector<uint16_t>> memory_;
+  Hook                                 hook_;
+  std::mutex                           mutex_;
+
+  static plc_slmp::RegisterType device_type(uint8_t code) {
+    using plc_slmp::RegisterType;
+    switch (code) {
+      case 0xA8:
+        return RegisterType::D_REGISTER;
+      case 0x9C:
+        return RegisterType::X_REGISTER;
+      case 0x9D:
+        return RegisterType::Y_REGISTER;
+      case 0x90:
+        return RegisterType::M_REGISTER;
+      case 0xA0:
+        return RegisterType::B_REGISTER;
+      case 0xA9:
+        return RegisterType::SD_REGISTER;
+      default:
+        return RegisterType::UNKNOWN;
+    }
+  }
+
+  static size_t word_index(const plc_slmp::DeviceAddress &a) {
+    return a.number / plc_slmp::points_per_word(a.type);
+  }
+
+  // mutex_ phải đang được giữ
+  std::vector<uint16_t> &memory(plc_slmp::RegisterType type) {
+    std::vector<uint16_t> &words = memory_[(int)type];
+    if (words.empty()) {
+      words.resize(1 << 16);
+    }
+    return words;
+  }
+
+  static bool recv_exact(int fd, uint8_t *buf, size_t len) {
+    while (len > 0) {
+      ssize_t n = ::recv(fd, buf, len, 0);
+      if (n <= 0) {
+        return false;
+      }
+      buf += n;
+      len -= (size_t)n;
+    }
+    return true;
+  }
+
+  static bool send_all(int fd, const uint8_t *buf, size_t len) {
+    while (len > 0) {
+      ssize_t n = ::send(fd, buf, len, MSG_NOSIGNAL);
+      if (n <= 0) {
+        return false;
+      }
+      buf += n;
+      len -= (size_t)n;
+    }
+    return true;
+  }
+
+  void accept_loop() {
+    while (!stopping_) {
+      int fd = ::accept(listen_fd_, nullptr, nullptr);
+      if (fd < 0) {
+        return;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_) {
+        ::close(fd);
+        return;
+      }
+      clients_.push_back(fd);
+      workers_.emplace_back([this, fd]() { serve(fd); });
+    }
+  }
+
+  void serve(int fd) {
+    std::vector<uint8_t> rx(8192), tx(8192);
+    while (recv_exact(fd, rx.data(), kHeader)) {
+      size_t body = (size_t)rx[7] | ((size_t)rx[8] << 8);
+      if (rx[0] != 0x50 || body < 12 || kHeader + body > rx.size() ||
+          !recv_exact(fd, rx.data() + kHeader, body)) {
+        break;
+      }
+      const uint8_t *req     = rx.data() + kHeader;
+      uint16_t       command = (uint16_t)(req[2] | (req[3] << 8));
+      plc_slmp::DeviceAddress start;
+      start.number = (uint32_t)req[6] | ((uint32_t)req[7] << 8) |
+                     ((uint32_t)req[8] << 16);
+      start.type = device_type(req[9]);
+      int  num   = req[10] | (req[11] << 8);
+      bool write = command == 0x1401;
+      if (start.type == plc_slmp::RegisterType::UNKNOWN ||
+          word_index(start) + (size_t)num > (1 << 16) ||
+          (write && body < 12 + (size_t)num * 2)) {
+        break;
+      }
+
+      Hook hook;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hook = hook_;
+      }
+      if (hook) {
+        hook(start, num, write);
+      }
+
+      size_t data_len = 0;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint16_t *words = memory(start.type).data() + word_index(start);
+        if (write) {
+          memcpy(words, req + 12, (size_t)num * 2);
+          writes_++;
+        } else {
+          memcpy(tx.data() + 11, words, (size_t)num * 2);
+          data_len = (size_t)num * 2;
+          reads_++;
+        }
+      }
+
+      int waiting = 0;
+      if (::ioctl(fd, FIONREAD, &waiting) == 0 && waiting > 0) {
+        pipelined_++;
+      }
+
+      const uint8_t head[] = {0xD0, 0x00, rx[2], rx[3], rx[4], rx[5], rx[6]};
+      memcpy(tx.data(), head, sizeof(head));
+      tx[7]  = (uint8_t)((data_len + 2) & 0xFF);
+      tx[8]  = (uint8_t)((data_len + 2) >> 8);
+      tx[9]  = 0;
+      tx[10] = 0;
+      if (!send_all(fd, tx.data(), 11 + data_len)) {
+        break;
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < clients_.size(); i++) {
+      if (clients_[i] == fd) {
+        clients_.erase(clients_.begin() + i);
+        break;
+      }
+    }
+    ::close(fd);
+  }
+};
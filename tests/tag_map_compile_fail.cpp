@@ -0,0 +1,30 @@
+// Mỗi trường hợp TAG_MAP_FAIL_CASE là một khai báo TagMap sai và phải làm
+// biên dịch thất bại. CMake build từng trường hợp thành một target riêng
+// (EXCLUDE_FROM_ALL) và test tương ứng đặt WILL_FAIL.
+
+#include "test_slmp/tag_map.hpp"
+
+using namespace plc_slmp;
+
+#if TAG_MAP_FAIL_CASE == 1
+// Địa chỉ sai
+constexpr TagMap kMap{Tag<uint16_t>("Q100", "bad")};
+#elif TAG_MAP_FAIL_CASE == 2
+// Trùng tên tag
+constexpr TagMap kMap{Tag<uint16_t>("D100", "speed"),
+                      Tag<uint16_t>("D200", "speed")};
+#elif TAG_MAP_FAIL_CASE == 3
+// Tag 32 bit ở D100 chồng lên D101
+constexpr TagMap kMap{Tag<int32_t>("D100", "speed"),
+                      Tag<uint16_t>("D101", "mode")};
+#elif TAG_MAP_FAIL_CASE == 4
+// bool trên thanh ghi word
+constexpr TagMap kMap{Tag<bool>("D100", "run")};
+#else
+// Khai báo hợp lệ, dùng để kiểm tra chính file này biên dịch được
+constexpr TagMap kMap{Tag<uint16_t>("D100", "speed")};
+#endif
+
+int main() {
+  return (int)kMap.frame_count() - 1;
+}
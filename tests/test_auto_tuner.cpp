@@ -0,0 +1,121 @@
+// Test AutoTuner: choose_params trên mô hình độ trễ tổng hợp, và tune() trên
+// PLC giả (FakeSlmpServer) có độ trễ per_frame + per_word * words.
+
+#include <chrono>
+#include <thread>
+
+#include "fake_slmp_server.hpp"
+#include "test_common.hpp"
+#include "test_slmp/auto_tuner.hpp"
+
+using namespace plc_slmp;
+
+namespace {
+
+// Cho phép test gọi choose_params với mô hình tự chọn
+class ModelTuner : public AutoTuner {
+public:
+  using AutoTuner::AutoTuner;
+  using AutoTuner::choose_params;
+};
+
+LatencyModel make_model(double per_frame_us, double per_word_us) {
+  LatencyModel model;
+  model.per_frame_us = per_frame_us;
+  model.per_word_us  = per_word_us;
+  return model;
+}
+
+double word_cost(const LatencyModel &model, int words) {
+  return model.predict_us(words) / words;
+}
+
+void test_choose_params() {
+  FakeSlmpServer server;
+  PlcClient      plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  TransferEngine engine(plc);
+
+  // Frame được chọn là frame nhỏ nhất có chi phí mỗi word trong 5% so với
+  // frame 960 word
+  ModelTuner     tuner(plc, engine);
+  LatencyModel   model  = make_model(2000.0, 1.0);
+  TransferParams params = tuner.choose_params(model);
+  const double   limit  = 1.05 * word_cost(model, kMaxBatchWords);
+  CHECK(params.max_frame_words < kMaxBatchWords);
+  CHECK(word_cost(model, params.max_frame_words) <= limit);
+  CHECK(word_cost(model, params.max_frame_words - 1) > limit);
+  // Khoảng gộp: số word có chi phí bằng một frame, không quá một frame
+  CHECK(params.coalesce_gap == params.max_frame_words);
+  CHECK(tuner.choose_params(make_model(200.0, 1.0)).coalesce_gap == 200);
+
+  // Slack lớn cho phép frame nhỏ hơn
+  AutoTunerConfig loose;
+  loose.word_cost_slack = 0.5;
+  ModelTuner loose_tuner(plc, engine, loose);
+  CHECK(loose_tuner.choose_params(model).max_frame_words <
+        params.max_frame_words);
+
+  // Không có chi phí mỗi frame: frame nhỏ nhất trong frame_sizes
+  CHECK(tuner.choose_params(make_model(0.0, 1.0)).max_frame_words == 16);
+  CHECK(tuner.choose_params(make_model(0.0, 1.0)).coalesce_gap == 0);
+
+  // Chỉ có chi phí mỗi frame: khoảng gộp bằng cả frame
+  params = tuner.choose_params(make_model(1000.0, 0.0));
+  CHECK(params.coalesce_gap == params.max_frame_words);
+
+  // frame_budget_us giới hạn độ trễ dự đoán của một frame
+  AutoTunerConfig budget;
+  budget.frame_budget_us = 500.0;
+  ModelTuner budget_tuner(plc, engine, budget);
+  params = budget_tuner.choose_params(make_model(100.0, 1.0));
+  CHECK(params.max_frame_words == 400);
+  // Ngân sách nhỏ hơn cả chi phí mỗi frame: frame nhỏ nhất
+  params = budget_tuner.choose_params(make_model(1000.0, 1.0));
+  CHECK(params.max_frame_words == 16);
+}
+
+void test_tune() {
+  // PLC giả trả lời sau 1 ms + 10 μs mỗi word
+  FakeSlmpServer server;
+  server.set_hook([](const DeviceAddress &, int num, bool) {
+    std::this_thread::sleep_for(std::chrono::microseconds(1000 + 10 * num));
+  });
+  PlcClient plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  plc.set_backend(PlcBackend::NATIVE);
+  CHECK(plc.init_plc());
+
+  TransferEngine  engine(plc);
+  AutoTunerConfig config;
+  config.repeats         = 5;
+  config.pipeline_depths = {1, 2};
+  ModelTuner tuner(plc, engine, config);
+  CHECK(tuner.tune());
+
+  // Sleep luôn dài hơn yêu cầu nên chỉ kiểm tra khoảng rộng
+  LatencyModel model = tuner.model();
+  CHECK(model.samples == 7 * 5);
+  CHECK(model.per_word_us > 5.0 && model.per_word_us < 20.0);
+  CHECK(model.per_frame_us > 500.0 && model.per_frame_us < 5000.0);
+
+  TransferParams expected = tuner.choose_params(model);
+  TransferParams params   = engine.params();
+  CHECK(params.max_frame_words == expected.max_frame_words);
+  CHECK(params.coalesce_gap == expected.coalesce_gap);
+  CHECK(params.pipeline_depth == 1 || params.pipeline_depth == 2);
+
+  // Lần đọc thử lỗi: giữ nguyên tham số cũ
+  plc.disconnect();
+  TransferParams manual;
+  manual.max_frame_words = 123;
+  engine.set_params(manual);
+  CHECK(!tuner.tune());
+  CHECK(engine.params().max_frame_words == 123);
+}
+
+}  // namespace
+
+int main() {
+  test_choose_params();
+  test_tune();
+  return test_result("test_auto_tuner");
+}
@@ -0,0 +1,134 @@
+// Test BufferPool: dùng lại slab, thống kê, cấp phát trên heap khi pool cạn
+// hoặc yêu cầu quá lớn, buffer sống lâu hơn pool, và đọc vào PooledBuffer
+// của PlcClient trên PLC giả (FakeSlmpServer).
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "fake_slmp_server.hpp"
+#include "test_common.hpp"
+#include "test_slmp/buffer_pool.hpp"
+#include "test_slmp/plc_client.hpp"
+
+using namespace plc_slmp;
+
+namespace {
+
+bool aligned(const PooledBuffer &buffer) {
+  return (uintptr_t)buffer.data() % kCacheLineSize == 0;
+}
+
+void test_reuse() {
+  BufferPool pool(2, 100);
+  CHECK(pool.slab_bytes() == 128);
+
+  PooledBuffer   first = pool.acquire();
+  unsigned char *slab  = first.data();
+  CHECK(first && first.size() == 128 && aligned(first));
+  first.release();
+  CHECK(!first && first.size() == 0);
+
+  // Slab vừa trả về được lấy lại, không cấp phát mới
+  PooledBuffer again = pool.acquire(64);
+  CHECK(again.data() == slab);
+
+  // Move chuyển quyền giữ slab, không trả về pool
+  PooledBuffer moved = std::move(again);
+  CHECK(!again && moved.data() == slab);
+  CHECK(pool.stats().in_use == 1);
+
+  BufferPoolStats stats = pool.stats();
+  CHECK(stats.slab_count == 2);
+  CHECK(stats.slab_bytes == 128);
+  CHECK(stats.acquires == 2);
+  CHECK(stats.high_water == 1);
+  CHECK(stats.fallbacks == 0);
+}
+
+void test_fallback() {
+  BufferPool pool(2, 128);
+  {
+    PooledBuffer a = pool.acquire();
+    PooledBuffer b = pool.acquire();
+    // Pool cạn: cấp phát riêng, vẫn căn theo cache line
+    PooledBuffer c = pool.acquire();
+    CHECK(c && c.size() == 128 && aligned(c));
+    CHECK(c.data() != a.data() && c.data() != b.data());
+
+    BufferPoolStats stats = pool.stats();
+    CHECK(stats.in_use == 3);
+    CHECK(stats.high_water == 3);
+    CHECK(stats.fallbacks == 1);
+  }
+  CHECK(pool.stats().in_use == 0);
+
+  // Yêu cầu lớn hơn slab: cấp phát riêng dù pool còn slab trống
+  PooledBuffer big = pool.acquire(1000);
+  CHECK(big && big.size() >= 1000 && aligned(big));
+  BufferPoolStats stats = pool.stats();
+  CHECK(stats.fallbacks == 2);
+  CHECK(stats.acquires == 4);
+  big.release();
+
+  // Slab trong pool vẫn dùng được sau khi buffer riêng được trả
+  PooledBuffer small = pool.acquire();
+  CHECK(pool.stats().fallbacks == 2);
+  CHECK(pool.stats().in_use == 1);
+}
+
+void test_outlive_pool() {
+  PooledBuffer buffer;
+  {
+    BufferPool pool(1, 64);
+    buffer = pool.acquire();
+  }
+  // Vùng nhớ slab vẫn hợp lệ tới khi buffer bị hủy
+  CHECK(buffer);
+  buffer.words()[0] = 0x1234;
+  CHECK(buffer.words()[0] == 0x1234);
+  buffer.release();
+}
+
+void test_client_read() {
+  FakeSlmpServer server;
+  PlcClient      plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP, 4);
+  plc.set_backend(PlcBackend::NATIVE);
+  CHECK(plc.init_plc());
+  server.set("D10", 10);
+  server.set("D11", 11);
+
+  PooledBuffer data;
+  CHECK(plc.read_batch_d_registers("D10", 2, data));
+  CHECK(data.words()[0] == 10 && data.words()[1] == 11);
+  const unsigned char *slab     = data.data();
+  const uint64_t       acquires = plc.pool_stats().acquires;
+
+  // Đọc lại vào cùng buffer dùng lại slab đang giữ
+  server.set("D10", 100);
+  CHECK(plc.read_batch_d_registers("D10", 2, data));
+  CHECK(data.data() == slab);
+  CHECK(data.words()[0] == 100);
+  // Chỉ tx/rx của frame được lấy từ pool, không lấy slab kết quả mới
+  CHECK(plc.pool_stats().acquires == acquires + 2);
+
+  CHECK(!plc.read_batch_d_registers("D10", kMaxBatchWords + 1, data));
+
+  // Lỗi đọc trả slab về pool
+  plc.disconnect();
+  CHECK(!plc.read_batch_d_registers("D10", 2, data));
+  CHECK(!data);
+  CHECK(plc.pool_stats().in_use == 0);
+  CHECK(plc.pool_stats().fallbacks == 0);
+}
+
+}  // namespace
+
+int main() {
+  test_reuse();
+  test_fallback();
+  test_outlive_pool();
+  test_client_read();
+  return test_result("test_buffer_pool");
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// Tiện ích dùng chung cho các test trong tests/. Mỗi test là một
+// executable, CHECK ghi lỗi và chạy tiếp, main trả về test_result().
+
+inline int &test_failures() {
+  static int failures = 0;
+  return failures;
+}
+
+#define CHECK(cond)                                       \
+  do {                                                    \
+    if (!(cond)) {                                        \
+      std::cerr << __FILE__ << ":" << __LINE__            \
+                << ": CHECK failed: " #cond << std::endl; \
+      test_failures()++;                                  \
+    }                                                     \
+  } while (0)
+
+inline int test_result(const char *name) {
+  if (test_failures() != 0) {
+    std::cerr << name << ": " << test_failures() << " check(s) failed"
+              << std::endl;
+    return 1;
+  }
+  std::cout << name << " passed" << std::endl;
+  return 0;
+}
+
+// Chuỗi hex liền nhau ("5000FF") thành byte
+inline std::vector<uint8_t> hex_bytes(const char *hex) {
+  std::vector<uint8_t> out;
+  for (size_t i = 0; hex[i] != '\0' && hex[i + 1] != '\0'; i += 2) {
+    auto nibble = [](char c) {
+      return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+    };
+    out.push_back((uint8_t)((nibble(hex[i]) << 4) | nibble(hex[i + 1])));
+  }
+  return out;
+}
@@ -0,0 +1,196 @@
+// Test backend native qua UDP với frame 4E: response được ghép theo serial,
+// datagram muộn, trùng hoặc đến sai thứ tự không làm đóng socket.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "test_common.hpp"
+#include "test_slmp/plc_client.hpp"
+#include "test_slmp/transfer_engine.hpp"
+
+using namespace plc_slmp;
+
+namespace {
+
+// PLC giả qua UDP, chỉ hỗ trợ batch read 4E binary, thanh ghi Dn có giá trị
+// n. Gom batch() request rồi trả lời theo thứ tự ngược lại; mỗi response
+// đi sau một datagram có serial lạ và đi trước một bản trùng của nó.
+class NoisyUdpPlc {
+public:
+  NoisyUdpPlc() {
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len        = sizeof(addr);
+    if (fd_ < 0 || ::bind(fd_, (sockaddr *)&addr, sizeof(addr)) != 0 ||
+        ::getsockname(fd_, (sockaddr *)&addr, &len) != 0) {
+      return;
+    }
+    port_   = ntohs(addr.sin_port);
+    thread_ = std::thread([this]() { serve(); });
+  }
+
+  ~NoisyUdpPlc() {
+    stopping_ = true;
+    ::shutdown(fd_, SHUT_RDWR);
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    ::close(fd_);
+  }
+
+  int port() const {
+    return port_;
+  }
+
+  // Số request gom lại trước khi trả lời, 0 là không trả lời
+  void set_batch(int batch) {
+    batch_ = batch;
+  }
+
+  uint64_t reads() const {
+    return reads_;
+  }
+
+private:
+  struct Request {
+    std::vector<uint8_t> frame;
+    sockaddr_in          from{};
+  };
+
+  int                   fd_   = -1;
+  int                   port_ = 0;
+  std::atomic<bool>     stopping_{false};
+  std::atomic<int>      batch_{1};
+  std::atomic<uint64_t> reads_{0};
+  std::thread           thread_;
+
+  void send_response(const Request &req, uint16_t serial, bool data) {
+    const uint8_t *r   = req.frame.data();
+    uint32_t       dev = r[19] | (r[20] << 8) | (r[21] << 16);
+    int            num = r[23] | (r[24] << 8);
+    std::vector<uint8_t> out = {0xD4, 0x00, (uint8_t)serial,
+                                (uint8_t)(serial >> 8), 0x00, 0x00,
+                                r[6], r[7], r[8], r[9], r[10],
+                                (uint8_t)(2 + num * 2),
+                                (uint8_t)((2 + num * 2) >> 8), 0x00, 0x00};
+    for (int i = 0; i < num; i++) {
+      uint16_t word = data ? (uint16_t)(dev + i) : 0xDEAD;
+      out.push_back((uint8_t)word);
+      out.push_back((uint8_t)(word >> 8));
+    }
+    ::sendto(fd_, out.data(), out.size(), 0, (const sockaddr *)&req.from,
+             sizeof(req.from));
+  }
+
+  void serve() {
+    std::vector<Request> pending;
+    uint8_t              buf[2048];
+    while (!stopping_) {
+      Request   req;
+      socklen_t len = sizeof(req.from);
+      ssize_t   n   = ::recvfrom(fd_, buf, sizeof(buf), 0,
+                             (sockaddr *)&req.from, &len);
+      if (n < 25 || buf[0] != 0x54 || buf[22] != 0xA8) {
+        continue;
+      }
+      reads_++;
+      req.frame.assign(buf, buf + n);
+      pending.push_back(req);
+      if (batch_ <= 0 || (int)pending.size() < batch_) {
+        continue;
+      }
+      for (size_t i = pending.size(); i > 0; i--) {
+        const Request &p      = pending[i - 1];
+        uint16_t       serial = (uint16_t)(p.frame[2] | (p.frame[3] << 8));
+        send_response(p, (uint16_t)(serial + 1000), false);
+        send_response(p, serial, true);
+        send_response(p, serial, false);
+      }
+      pending.clear();
+    }
+  }
+};
+
+bool connect(PlcClient &plc, int timeout_ms = 1000) {
+  SlmpFrameConfig frame;
+  frame.frame = SlmpFrameType::FRAME_4E;
+  plc.set_backend(PlcBackend::NATIVE, frame, timeout_ms);
+  return plc.init_plc();
+}
+
+void test_stale_and_duplicate() {
+  NoisyUdpPlc server;
+  PlcClient   plc("127.0.0.1", server.port(), MELCLI_TYPE_UDPIP);
+  CHECK(connect(plc));
+
+  // Datagram có serial lạ và bản trùng của response trước bị bỏ qua
+  for (int i = 0; i < 5; i++) {
+    std::vector<uint16_t> data;
+    CHECK(plc.read_batch_d_registers("D10", 3, data));
+    CHECK(data == std::vector<uint16_t>({10, 11, 12}));
+  }
+  CHECK(server.reads() == 5);
+}
+
+void test_pipeline_out_of_order() {
+  NoisyUdpPlc server;
+  PlcClient   plc("127.0.0.1", server.port(), MELCLI_TYPE_UDPIP);
+  CHECK(connect(plc));
+
+  // 4 frame được gửi liền nhau và nhận lại theo thứ tự ngược
+  server.set_batch(4);
+  TransferParams params;
+  params.pipeline_depth = 4;
+  TransferEngine        engine(plc, params);
+  std::vector<uint16_t> data;
+  CHECK(engine.read_range("D0", 4 * kMaxBatchWords, data));
+  bool same = data.size() == 4 * kMaxBatchWords;
+  for (size_t i = 0; same && i < data.size(); i++) {
+    same = data[i] == (uint16_t)i;
+  }
+  CHECK(same);
+  CHECK(server.reads() == 4);
+
+  // Response muộn của lần trước không ảnh hưởng lần đọc kế tiếp
+  server.set_batch(1);
+  uint16_t word = 0;
+  CHECK(plc.read_batch_d_register("D77", word));
+  CHECK(word == 77);
+}
+
+void test_timeout() {
+  NoisyUdpPlc server;
+  PlcClient   plc("127.0.0.1", server.port(), MELCLI_TYPE_UDPIP);
+  CHECK(connect(plc, 100));
+
+  server.set_batch(0);
+  auto     begin = std::chrono::steady_clock::now();
+  uint16_t word  = 0;
+  CHECK(!plc.read_batch_d_register("D1", word));
+  CHECK(std::chrono::steady_clock::now() - begin <
+        std::chrono::milliseconds(1000));
+
+  // Hết hạn thì socket bị đóng, init_plc() kết nối lại
+  server.set_batch(1);
+  CHECK(!plc.read_batch_d_register("D1", word));
+  CHECK(connect(plc, 100));
+  CHECK(plc.read_batch_d_register("D2", word) && word == 2);
+}
+
+}  // namespace
+
+int main() {
+  test_stale_and_duplicate();
+  test_pipeline_out_of_order();
+  test_timeout();
+  return test_result("test_native_udp");
+}
@@ -0,0 +1,176 @@
+// Test AsyncPlcClient và PlcEventLoop trên PLC giả (FakeSlmpServer): đọc/ghi
+// pipeline từ nhiều coroutine, request quá hạn, và stop().
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fake_slmp_server.hpp"
+#include "test_common.hpp"
+#include "test_slmp/plc_async.hpp"
+
+using namespace std::chrono_literals;
+using namespace plc_slmp;
+
+namespace {
+
+// Ghi value vào addr rồi đọc lại, tăng ok nếu cả hai thành công và khớp
+PlcTask<void> write_read(AsyncPlcClient &plc,
+                         std::string     addr,
+                         uint16_t        value,
+                         int            &ok) {
+  uint16_t check = 0;
+  if (co_await plc.write(addr.c_str(), value) &&
+      co_await plc.read(addr.c_str(), check) && check == value) {
+    ok++;
+  }
+}
+
+PlcTask<void> read_block(AsyncPlcClient &plc, uint16_t *data, bool &ok) {
+  ok = co_await plc.read("D100", 4, data);
+}
+
+void test_pipeline() {
+  FakeSlmpServer server;
+  // Giữ mỗi response một chút để các request sau kịp tới
+  server.set_hook([](const DeviceAddress &, int, bool) {
+    std::this_thread::sleep_for(2ms);
+  });
+  for (int i = 0; i < 4; i++) {
+    server.set(("D" + std::to_string(100 + i)).c_str(), (uint16_t)(40 + i));
+  }
+
+  PlcEventLoop   loop;
+  AsyncPlcClient plc(loop, "127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  CHECK(plc.init_plc());
+
+  const int kTasks = 8;
+  int       ok     = 0;
+  for (int i = 0; i < kTasks; i++) {
+    loop.spawn(
+      write_read(plc, "D" + std::to_string(10 + i), (uint16_t)(500 + i), ok));
+  }
+  uint16_t block[4] = {};
+  bool     read_ok  = false;
+  loop.spawn(read_block(plc, block, read_ok));
+  loop.run();
+
+  CHECK(ok == kTasks);
+  CHECK(read_ok);
+  CHECK(block[0] == 40 && block[3] == 43);
+  CHECK(server.get("D10") == 500);
+  CHECK(server.get("D17") == 507);
+  CHECK(server.writes() == kTasks);
+  CHECK(server.reads() == kTasks + 1);
+  // Với pipeline_depth 4, request được gửi trước khi có response trước
+  CHECK(server.pipelined() > 0);
+  CHECK(loop.tasks_alive() == 0);
+}
+
+void test_no_pipeline() {
+  FakeSlmpServer server;
+  server.set_hook([](const DeviceAddress &, int, bool) {
+    std::this_thread::sleep_for(2ms);
+  });
+  PlcEventLoop   loop;
+  AsyncPlcClient plc(
+    loop, "127.0.0.1", server.port(), MELCLI_TYPE_TCPIP, {}, 1000, 1);
+  CHECK(plc.init_plc());
+
+  int ok = 0;
+  for (int i = 0; i < 4; i++) {
+    loop.spawn(write_read(plc, "D" + std::to_string(i), (uint16_t)i, ok));
+  }
+  loop.run();
+  CHECK(ok == 4);
+  CHECK(server.pipelined() == 0);
+}
+
+PlcTask<void> read_one(AsyncPlcClient &plc, const char *addr, int &result) {
+  uint16_t value = 0;
+  result         = co_await plc.read(addr, value) ? 1 : 0;
+}
+
+void test_timeout() {
+  FakeSlmpServer server;
+  // D50 trả lời sau 300 ms, quá timeout 100 ms của client
+  server.set_hook([](const DeviceAddress &start, int, bool) {
+    if (start.number == 50) {
+      std::this_thread::sleep_for(300ms);
+    }
+  });
+  PlcEventLoop   loop;
+  AsyncPlcClient plc(
+    loop, "127.0.0.1", server.port(), MELCLI_TYPE_TCPIP, {}, 100);
+  CHECK(plc.init_plc());
+
+  int  slow = -1, queued = -1;
+  auto begin = std::chrono::steady_clock::now();
+  loop.spawn(read_one(plc, "D50", slow));
+  loop.spawn(read_one(plc, "D51", queued));
+  loop.run();
+  CHECK(std::chrono::steady_clock::now() - begin < 250ms);
+
+  // TCP: request quá hạn đóng kết nối và trả lỗi cho mọi request đang chờ
+  CHECK(slow == 0);
+  CHECK(queued == 0);
+  CHECK(!plc.is_connected());
+
+  // Kết nối lại thì đọc được tiếp
+  server.set("D51", 51);
+  CHECK(plc.init_plc());
+  int again = -1;
+  loop.spawn(read_one(plc, "D51", again));
+  loop.run();
+  CHECK(again == 1);
+}
+
+PlcTask<void> poll_until(PlcEventLoop      &loop,
+                         std::atomic<bool> &done,
+                         std::atomic<int>  &ticks) {
+  while (!done) {
+    ticks++;
+    co_await loop.sleep_for(5ms);
+  }
+}
+
+void test_stop() {
+  PlcEventLoop      loop;
+  std::atomic<bool> done{false};
+  std::atomic<int>  ticks{0};
+  loop.spawn(poll_until(loop, done, ticks));
+
+  // stop() trước run() không bị mất: run() trả về ngay
+  loop.stop();
+  auto begin = std::chrono::steady_clock::now();
+  loop.run();
+  CHECK(std::chrono::steady_clock::now() - begin < 100ms);
+  CHECK(loop.tasks_alive() == 1);
+
+  // stop() từ thread khác
+  std::thread stopper([&]() {
+    std::this_thread::sleep_for(50ms);
+    loop.stop();
+  });
+  loop.run();
+  stopper.join();
+  CHECK(ticks > 0);
+  CHECK(loop.tasks_alive() == 1);
+
+  // Sau stop(), run() lại chạy tiếp task cho tới khi xong
+  done = true;
+  loop.run();
+  CHECK(loop.tasks_alive() == 0);
+}
+
+}  // namespace
+
+int main() {
+  test_pipeline();
+  test_no_pipeline();
+  test_timeout();
+  test_stop();
+  return test_result("test_plc_async");
+}
@@ -0,0 +1,131 @@
+// Test RegionMirror trên PLC giả (FakeSlmpServer): nạp bản sao, phát hiện
+// thay đổi, và write() chen vào giữa lần đọc PLC và lúc commit của một lần
+// làm mới.
+
+#include <chrono>
+#include <thread>
+
+#include "fake_slmp_server.hpp"
+#include "test_common.hpp"
+#include "test_slmp/region_mirror.hpp"
+
+using namespace plc_slmp;
+
+namespace {
+
+// Cho phép test chạy một bước giữa lần đọc PLC và lúc commit
+class SteppedMirror : public RegionMirror {
+public:
+  using RegionMirror::RegionMirror;
+  using RegionMirror::refresh_once;
+};
+
+// hot_period == cold_period: mọi segment đến hạn ở mỗi tick, nên mỗi lần
+// refresh_once sau khi chờ một tick đều đọc lại toàn bộ vùng
+MirrorParams every_tick() {
+  MirrorParams params;
+  params.segment_words = 64;
+  params.hot_period    = std::chrono::milliseconds(20);
+  params.cold_period   = std::chrono::milliseconds(20);
+  return params;
+}
+
+void wait_tick() {
+  std::this_thread::sleep_for(std::chrono::milliseconds(25));
+}
+
+void test_load_and_change() {
+  FakeSlmpServer server;
+  PlcClient      plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  plc.set_backend(PlcBackend::NATIVE);
+  CHECK(plc.init_plc());
+  server.set("D10", 10);
+  server.set("D130", 130);
+
+  RegionMirror mirror(plc, "D0", 200, every_tick());
+  CHECK(mirror.init());
+  uint16_t value = 0;
+  CHECK(!mirror.read("D10", value));
+  CHECK(mirror.refresh_once());
+  CHECK(mirror.read("D10", value) && value == 10);
+  CHECK(mirror.read("D130", value) && value == 130);
+
+  MirrorStats stats = mirror.stats();
+  CHECK(stats.segments == 4);
+  CHECK(stats.segment_reads == 4);
+  CHECK(stats.changes == 0);
+  CHECK(stats.hot_segments == 0);
+
+  // Dữ liệu đổi trên PLC: segment được cập nhật và lên tầng nóng
+  const uint64_t sequence = mirror.sequence("D130");
+  server.set("D130", 1300);
+  wait_tick();
+  CHECK(mirror.refresh_once());
+  CHECK(mirror.read("D130", value) && value == 1300);
+  CHECK(mirror.sequence("D130") == sequence + 1);
+  CHECK(mirror.tier("D130") == MirrorTier::HOT);
+  CHECK(mirror.tier("D10") == MirrorTier::COLD);
+  stats = mirror.stats();
+  CHECK(stats.changes == 1);
+  CHECK(stats.promotions == 1);
+}
+
+void test_write_during_refresh() {
+  FakeSlmpServer server;
+  PlcClient      plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  plc.set_backend(PlcBackend::NATIVE);
+  CHECK(plc.init_plc());
+  server.set("D70", 70);
+
+  SteppedMirror mirror(plc, "D0", 200, every_tick());
+  CHECK(mirror.init());
+  CHECK(mirror.refresh_once());
+
+  // Lần làm mới đọc D70 = 70, rồi write() ghi 7000 trước khi commit. Kết
+  // quả đọc cũ không được ghi đè lên giá trị vừa ghi, không tính là thay
+  // đổi và không làm segment lên tầng nóng.
+  const uint16_t written = 7000;
+  wait_tick();
+  CHECK(mirror.refresh_once(
+    [&]() { CHECK(mirror.write("D70", 1, &written)); }));
+  CHECK(server.get("D70") == written);
+
+  uint16_t value = 0;
+  CHECK(mirror.read("D70", value) && value == written);
+  CHECK(mirror.tier("D70") == MirrorTier::COLD);
+  MirrorStats stats = mirror.stats();
+  CHECK(stats.changes == 0);
+  CHECK(stats.promotions == 0);
+
+  // Lần làm mới kế tiếp đọc lại segment và thấy đúng giá trị đã ghi
+  wait_tick();
+  CHECK(mirror.refresh_once());
+  CHECK(mirror.read("D70", value) && value == written);
+  stats = mirror.stats();
+  CHECK(stats.changes == 0);
+  CHECK(stats.promotions == 0);
+}
+
+void test_write_outside_region() {
+  FakeSlmpServer server;
+  PlcClient      plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  plc.set_backend(PlcBackend::NATIVE);
+  CHECK(plc.init_plc());
+
+  RegionMirror mirror(plc, "D0", 200, every_tick());
+  CHECK(mirror.init());
+  const uint16_t value = 1;
+  CHECK(!mirror.write("D200", 1, &value));
+  CHECK(!mirror.write("D199", 2, &value));
+  CHECK(!mirror.write("M0", 1, &value));
+  CHECK(server.writes() == 0);
+}
+
+}  // namespace
+
+int main() {
+  test_load_and_change();
+  test_write_during_refresh();
+  test_write_outside_region();
+  return test_result("test_region_mirror");
+}
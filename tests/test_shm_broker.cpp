@@ -0,0 +1,216 @@
+// Test ShmBroker và ShmImageClient trên PLC giả (FakeSlmpServer): công bố
+// khối qua shared memory, sequence chỉ đổi khi dữ liệu đổi, hàng đợi ghi,
+// yêu cầu ghi hỏng trong segment, và segment của broker còn sống/đã chết.
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fake_slmp_server.hpp"
+#include "test_common.hpp"
+#include "test_slmp/shm_broker.hpp"
+
+using namespace std::chrono_literals;
+using namespace plc_slmp;
+
+namespace {
+
+// Tên segment riêng cho mỗi lần chạy để các test chạy song song không đụng
+// nhau
+std::string unique_name(const char *tag) {
+  return std::string("test_") + tag + "_" + std::to_string(getpid());
+}
+
+bool connect(PlcClient &plc) {
+  plc.set_backend(PlcBackend::NATIVE);
+  return plc.init_plc();
+}
+
+bool segment_exists(const std::string &name) {
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  return fd >= 0;
+}
+
+void test_publish() {
+  FakeSlmpServer server;
+  PlcClient      plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  CHECK(connect(plc));
+  for (int i = 0; i < 4; i++) {
+    server.set(("D" + std::to_string(100 + i)).c_str(), (uint16_t)(10 + i));
+  }
+  server.set("D200", 200);
+
+  const std::string name = unique_name("publish");
+  ShmBroker broker(plc, name, {{"D100", 4}, {"D200", 2}});
+  CHECK(broker.create());
+  CHECK(broker.poll_once());
+
+  ShmImageClient client(name);
+  CHECK(client.attach());
+  CHECK(client.block_count() == 2);
+  CHECK(std::string(client.block_addr(1)) == "D200");
+  CHECK(client.block_size(0) == 4);
+  CHECK(client.block_status(0) == ShmBlockStatus::OK);
+  CHECK(client.broker_alive(1000ms));
+
+  uint16_t block[4] = {};
+  uint64_t sequence = 0;
+  CHECK(client.read_block(0, block, &sequence));
+  CHECK(block[0] == 10 && block[3] == 13);
+  CHECK(sequence == client.block_sequence(0));
+  const uint64_t other = client.block_sequence(1);
+
+  // Dữ liệu không đổi: sequence giữ nguyên
+  CHECK(broker.poll_once());
+  CHECK(client.block_sequence(0) == sequence);
+
+  // Chỉ khối có dữ liệu đổi mới tăng sequence
+  server.set("D101", 1100);
+  CHECK(broker.poll_once());
+  CHECK(client.block_sequence(0) == sequence + 2);
+  CHECK(client.block_sequence(1) == other);
+  uint16_t value = 0;
+  CHECK(client.read("D101", 1, &value) && value == 1100);
+  CHECK(!client.read("D103", 2, block));
+  CHECK(broker.cycle() == 3);
+}
+
+void test_writes() {
+  FakeSlmpServer server;
+  PlcClient      plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  CHECK(connect(plc));
+
+  const std::string name = unique_name("writes");
+  ShmBroker         broker(plc, name, {{"D0", 8}});
+  CHECK(broker.create());
+  ShmImageClient client(name);
+  CHECK(client.attach());
+
+  // Yêu cầu ghi được broker thực hiện trên PLC
+  const uint16_t data[2] = {0x1234, 0x5678};
+  uint64_t       ticket  = 0;
+  CHECK(client.write("D300", 2, data, &ticket));
+  CHECK(broker.process_writes() == 1);
+  CHECK(server.get("D300") == 0x1234 && server.get("D301") == 0x5678);
+  CHECK(client.wait_write(ticket, 100ms));
+
+  // Qua thread nền
+  broker.start(5ms);
+  const uint16_t next = 77;
+  CHECK(client.write("D2", 1, &next, &ticket));
+  CHECK(client.wait_write(ticket, 1000ms));
+  CHECK(server.get("D2") == 77);
+  broker.stop();
+
+  // Tiến trình có quyền ghi segment hàng đợi có thể sửa slot sau khi push:
+  // broker phải từ chối num ngoài giới hạn và addr không kết thúc bằng NUL
+  ShmSegment segment;
+  CHECK(segment.open(shm_queue_name(name), true));
+  ShmWriteQueue queue(segment.data());
+  CHECK(queue.valid());
+  std::vector<uint16_t> big(kShmMaxWriteWords + 1, 1);
+  CHECK(!queue.try_push("D0", kShmMaxWriteWords + 1, big.data(), ticket));
+  CHECK(!queue.try_push("D0", 0, big.data(), ticket));
+
+  ShmWriteSlot *slots = (ShmWriteSlot *)((char *)segment.data() +
+                                         sizeof(ShmQueueHeader));
+  const uint64_t writes = server.writes();
+  uint64_t       bad_num, bad_addr, good;
+  CHECK(queue.try_push("D400", 1, data, bad_num));
+  slots[bad_num % kShmQueueCapacity].num = kShmMaxWriteWords + 100;
+  CHECK(queue.try_push("D400", 1, data, bad_addr));
+  memset(slots[bad_addr % kShmQueueCapacity].addr, '1', kMaxAddressLength);
+  slots[bad_addr % kShmQueueCapacity].addr[0] = 'D';
+  CHECK(queue.try_push("D400", 1, data, good));
+
+  CHECK(broker.process_writes() == 3);
+  CHECK(queue.result(bad_num) == 0);
+  CHECK(queue.result(bad_addr) == 0);
+  CHECK(queue.result(good) == 1);
+  CHECK(server.writes() == writes + 1);
+  CHECK(server.get("D400") == 0x1234);
+}
+
+void test_start_stop() {
+  FakeSlmpServer server;
+  PlcClient      plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  CHECK(connect(plc));
+
+  ShmBroker broker(plc, unique_name("start"), {{"D0", 4}});
+  CHECK(broker.create());
+  // stop() ngay sau start(), trước khi thread kịp chạy, không được treo
+  for (int i = 0; i < 100; i++) {
+    broker.start(1ms);
+    broker.stop();
+  }
+
+  // run() trên thread hiện tại, stop() từ thread khác
+  std::thread stopper([&]() {
+    std::this_thread::sleep_for(30ms);
+    broker.stop();
+  });
+  broker.run(5ms);
+  stopper.join();
+  CHECK(broker.cycle() > 0);
+}
+
+void test_live_and_stale() {
+  const std::string name = unique_name("owner");
+  PlcClient         plc("127.0.0.1", 1, MELCLI_TYPE_TCPIP);
+
+  // Broker cùng tên còn sống: create() thất bại, segment cũ giữ nguyên
+  {
+    ShmBroker first(plc, name, {{"D0", 4}});
+    CHECK(first.create());
+    ShmBroker second(plc, name, {{"D0", 4}});
+    CHECK(!second.create());
+    CHECK(!shm_remove_stale(name));
+    ShmImageClient client(name);
+    CHECK(client.attach());
+  }
+  CHECK(!segment_exists(shm_image_name(name)));
+
+  // Broker chết mà không dọn segment
+  pid_t child = fork();
+  if (child == 0) {
+    ShmBroker broker(plc, name, {{"D0", 4}});
+    _exit(broker.create() ? 0 : 1);
+  }
+  int status = 0;
+  CHECK(child > 0 && waitpid(child, &status, 0) == child);
+  CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  CHECK(segment_exists(shm_image_name(name)));
+  CHECK(segment_exists(shm_queue_name(name)));
+
+  CHECK(shm_remove_stale(name));
+  CHECK(!segment_exists(shm_image_name(name)));
+  CHECK(!segment_exists(shm_queue_name(name)));
+
+  // create() cũng tự dọn segment của broker đã chết
+  child = fork();
+  if (child == 0) {
+    ShmBroker broker(plc, name, {{"D0", 4}});
+    _exit(broker.create() ? 0 : 1);
+  }
+  CHECK(child > 0 && waitpid(child, &status, 0) == child);
+  ShmBroker broker(plc, name, {{"D0", 4}});
+  CHECK(broker.create());
+}
+
+}  // namespace
+
+int main() {
+  test_publish();
+  test_writes();
+  test_start_stop();
+  test_live_and_stale();
+  return test_result("test_shm_broker");
+}
@@ -0,0 +1,323 @@
+// Unit test cho SlmpCodec và các hàm SIMD trong simd_utils.hpp: frame
+// chuẩn 3E/4E binary/ASCII, end code lỗi, response thiếu hoặc sai, và so
+// sánh đường SIMD với đường scalar.
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test_common.hpp"
+#include "test_slmp/slmp_codec.hpp"
+
+using namespace plc_slmp;
+
+namespace {
+
+SlmpCodec make_codec(SlmpFrameType frame, SlmpEncoding encoding) {
+  SlmpFrameConfig config;
+  config.frame    = frame;
+  config.encoding = encoding;
+  return SlmpCodec(config);
+}
+
+const SlmpCodec k3EBinary =
+  make_codec(SlmpFrameType::FRAME_3E, SlmpEncoding::BINARY);
+const SlmpCodec k4EBinary =
+  make_codec(SlmpFrameType::FRAME_4E, SlmpEncoding::BINARY);
+const SlmpCodec k3EAscii =
+  make_codec(SlmpFrameType::FRAME_3E, SlmpEncoding::ASCII);
+const SlmpCodec k4EAscii =
+  make_codec(SlmpFrameType::FRAME_4E, SlmpEncoding::ASCII);
+
+std::vector<uint8_t> ascii_bytes(const char *text) {
+  return std::vector<uint8_t>(text, text + strlen(text));
+}
+
+std::vector<uint8_t> encode_read(const SlmpCodec &codec,
+                                 const char      *addr,
+                                 int              num,
+                                 uint16_t         serial = 0) {
+  uint8_t buf[128];
+  size_t  len =
+    codec.encode_read(buf, sizeof(buf), parse_device_address(addr), num,
+                      serial);
+  return std::vector<uint8_t>(buf, buf + len);
+}
+
+std::vector<uint8_t> encode_write(const SlmpCodec &codec,
+                                  const char      *addr,
+                                  int              num,
+                                  const uint16_t  *data,
+                                  uint16_t         serial = 0) {
+  uint8_t buf[128];
+  size_t  len = codec.encode_write(
+    buf, sizeof(buf), parse_device_address(addr), num, data, serial);
+  return std::vector<uint8_t>(buf, buf + len);
+}
+
+void test_encode_read() {
+  CHECK(encode_read(k3EBinary, "D100", 10) ==
+        hex_bytes("500000FFFF03000C00100001040000640000A80A00"));
+  CHECK(encode_read(k4EBinary, "D100", 10, 0x1234) ==
+        hex_bytes("540034120000"
+                  "00FFFF03000C00100001040000640000A80A00"));
+  CHECK(encode_read(k3EAscii, "D100", 10) ==
+        ascii_bytes("500000FF03FF000018001004010000D*000100000A"));
+  CHECK(encode_read(k4EAscii, "D100", 10, 0x1234) ==
+        ascii_bytes("540012340000"
+                    "00FF03FF000018001004010000D*000100000A"));
+
+  // X đánh số hệ 16: X1F0 là điểm 0x1F0
+  CHECK(encode_read(k3EAscii, "X1F0", 1) ==
+        ascii_bytes("500000FF03FF000018001004010000X*0001F00001"));
+  CHECK(encode_read(k3EBinary, "SD10", 1) ==
+        hex_bytes("500000FFFF03000C00100001040000"
+                  "0A0000A90100"));
+}
+
+void test_encode_read_bits() {
+  uint8_t buf[64];
+  size_t  len = k3EBinary.encode_read_bits(
+    buf, sizeof(buf), parse_device_address("X10"), 20);
+  CHECK(std::vector<uint8_t>(buf, buf + len) ==
+        hex_bytes("500000FFFF03000C00100001040100100000" "9C1400"));
+  len = k3EAscii.encode_read_bits(
+    buf, sizeof(buf), parse_device_address("M100"), 3);
+  CHECK(std::vector<uint8_t>(buf, buf + len) ==
+        ascii_bytes("500000FF03FF000018001004010001M*0001000003"));
+
+  // Thiết bị word không đọc được theo bit
+  CHECK(k3EBinary.encode_read_bits(
+          buf, sizeof(buf), parse_device_address("D0"), 1) == 0);
+  CHECK(k3EBinary.encode_read_bits(
+          buf, sizeof(buf), parse_device_address("M0"), kMaxBatchBits + 1) ==
+        0);
+}
+
+void test_encode_write() {
+  const uint16_t data[2] = {0x1234, 0xABCD};
+  CHECK(encode_write(k3EBinary, "D100", 2, data) ==
+        hex_bytes("500000FFFF0300100010000114000064"
+                  "0000A802003412CDAB"));
+  CHECK(encode_write(k4EBinary, "D100", 2, data, 7) ==
+        hex_bytes("540007000000"
+                  "00FFFF0300100010000114000064"
+                  "0000A802003412CDAB"));
+  CHECK(encode_write(k3EAscii, "D100", 2, data) ==
+        ascii_bytes("500000FF03FF00"
+                    "002000101401"
+                    "0000D*0001000002"
+                    "1234ABCD"));
+}
+
+void test_encode_rejects() {
+  uint8_t       buf[4096];
+  uint16_t      data[kMaxBatchWords + 1] = {};
+  DeviceAddress d0 = parse_device_address("D0");
+
+  CHECK(k3EBinary.encode_read(buf, sizeof(buf), d0, 0) == 0);
+  CHECK(k3EBinary.encode_read(buf, sizeof(buf), d0, -1) == 0);
+  CHECK(k3EBinary.encode_read(buf, sizeof(buf), d0, kMaxBatchWords + 1) ==
+        0);
+  CHECK(k3EBinary.encode_read(buf, sizeof(buf), DeviceAddress{}, 1) == 0);
+  CHECK(k3EBinary.encode_read(buf, 8, d0, 1) == 0);
+  CHECK(k3EAscii.encode_write(buf, 64, d0, 10, data) == 0);
+  CHECK(k3EAscii.encode_write(
+          buf, sizeof(buf), d0, kMaxBatchWords + 1, data) == 0);
+  // 18 byte header, 24 byte request, 4 ký tự mỗi word
+  CHECK(k3EAscii.encode_write(buf, sizeof(buf), d0, kMaxBatchWords, data) ==
+        42 + (size_t)kMaxBatchWords * 4);
+}
+
+// Response thành công chứa 2 word 0x1234, 0xABCD
+void check_words(const SlmpCodec            &codec,
+                 const std::vector<uint8_t> &frame,
+                 uint16_t                    serial) {
+  SlmpResponse resp;
+  CHECK(codec.decode_response(frame.data(), frame.size(), resp));
+  CHECK(resp.end_code == 0);
+  CHECK(resp.serial == serial);
+  uint16_t words[2] = {};
+  CHECK(codec.decode_words(resp, words, 2));
+  CHECK(words[0] == 0x1234 && words[1] == 0xABCD);
+  // Số word không khớp với độ dài dữ liệu
+  CHECK(!codec.decode_words(resp, words, 1));
+  CHECK(!codec.decode_words(resp, words, 3));
+}
+
+void test_decode_response() {
+  check_words(k3EBinary, hex_bytes("D00000FFFF0300060000003412CDAB"), 0);
+  check_words(k4EBinary,
+              hex_bytes("D40034120000"
+                        "00FFFF0300060000003412CDAB"),
+              0x1234);
+  check_words(k3EAscii, ascii_bytes("D00000FF03FF00000C00001234ABCD"), 0);
+  check_words(k4EAscii,
+              ascii_bytes("D40012340000"
+                          "00FF03FF00000C00001234abcd"),
+              0x1234);
+
+  // Response của lệnh ghi: chỉ có end code
+  SlmpResponse resp;
+  std::vector<uint8_t> ack = hex_bytes("D00000FFFF030002000000");
+  CHECK(k3EBinary.decode_response(ack.data(), ack.size(), resp));
+  CHECK(resp.end_code == 0 && resp.data_len == 0);
+}
+
+void test_error_end_code() {
+  // End code 0xC051 kèm 9 byte thông tin lỗi (network .. subcommand)
+  std::vector<uint8_t> frame =
+    hex_bytes("D00000FFFF03000B0051C000FFFF0300" "01040000");
+  SlmpResponse resp;
+  CHECK(k3EBinary.decode_response(frame.data(), frame.size(), resp));
+  CHECK(resp.end_code == 0xC051);
+  CHECK(resp.data_len == 9);
+  uint16_t words[2];
+  CHECK(!k3EBinary.decode_words(resp, words, 2));
+
+  std::vector<uint8_t> text =
+    ascii_bytes("D00000FF03FF000016C05900FF03FF000401" "0000");
+  CHECK(k3EAscii.decode_response(text.data(), text.size(), resp));
+  CHECK(resp.end_code == 0xC059);
+}
+
+void test_truncated_response() {
+  std::vector<uint8_t> frame = hex_bytes("D00000FFFF0300060000003412CDAB");
+  SlmpResponse         resp;
+
+  // Mọi độ dài ngắn hơn frame đều bị từ chối
+  for (size_t len = 0; len < frame.size(); len++) {
+    CHECK(!k3EBinary.decode_response(frame.data(), len, resp));
+  }
+  // Dư byte cũng bị từ chối
+  std::vector<uint8_t> longer = frame;
+  longer.push_back(0);
+  CHECK(!k3EBinary.decode_response(longer.data(), longer.size(), resp));
+
+  // Subheader sai hoặc nhầm loại frame
+  std::vector<uint8_t> bad = frame;
+  bad[0]                   = 0xD4;
+  CHECK(!k3EBinary.decode_response(bad.data(), bad.size(), resp));
+  CHECK(!k4EBinary.decode_response(frame.data(), frame.size(), resp));
+
+  // Trường length nhỏ hơn end code
+  std::vector<uint8_t> tiny = hex_bytes("D00000FFFF03000100" "00");
+  CHECK(!k3EBinary.decode_response(tiny.data(), tiny.size(), resp));
+
+  // ASCII: length hoặc end code không phải hex
+  std::vector<uint8_t> text = ascii_bytes("D00000FF03FF00000C00001234ABCD");
+  for (size_t len = 0; len < text.size(); len++) {
+    CHECK(!k3EAscii.decode_response(text.data(), len, resp));
+  }
+  std::vector<uint8_t> bad_len = text;
+  bad_len[15]                  = 'G';
+  CHECK(!k3EAscii.decode_response(bad_len.data(), bad_len.size(), resp));
+  std::vector<uint8_t> bad_end = text;
+  bad_end[18]                  = 'x';
+  CHECK(!k3EAscii.decode_response(bad_end.data(), bad_end.size(), resp));
+
+  // Dữ liệu ASCII không phải hex
+  std::vector<uint8_t> bad_data = text;
+  bad_data[25]                  = 'Z';
+  uint16_t words[2];
+  CHECK(k3EAscii.decode_response(bad_data.data(), bad_data.size(), resp));
+  CHECK(!k3EAscii.decode_words(resp, words, 2));
+}
+
+void test_decode_bits() {
+  uint8_t      bits[4] = {};
+  SlmpResponse resp;
+
+  // Binary: điểm đầu ở nibble cao
+  std::vector<uint8_t> frame = hex_bytes("D00000FFFF030004000000" "1001");
+  CHECK(k3EBinary.decode_response(frame.data(), frame.size(), resp));
+  CHECK(k3EBinary.decode_bits(resp, bits, 4));
+  CHECK(bits[0] == 1 && bits[1] == 0 && bits[2] == 0 && bits[3] == 1);
+  CHECK(k3EBinary.decode_bits(resp, bits, 3));
+  CHECK(!k3EBinary.decode_bits(resp, bits, 2));
+
+  std::vector<uint8_t> text = ascii_bytes("D00000FF03FF0000070000101");
+  CHECK(k3EAscii.decode_response(text.data(), text.size(), resp));
+  CHECK(k3EAscii.decode_bits(resp, bits, 3));
+  CHECK(bits[0] == 1 && bits[1] == 0 && bits[2] == 1);
+  CHECK(!k3EAscii.decode_bits(resp, bits, 2));
+
+  std::vector<uint8_t> bad = ascii_bytes("D00000FF03FF0000070000121");
+  CHECK(k3EAscii.decode_response(bad.data(), bad.size(), resp));
+  CHECK(!k3EAscii.decode_bits(resp, bits, 3));
+}
+
+// Chạy qua đủ độ dài để phủ cả vòng SIMD 8 word và phần đuôi scalar
+void test_hex_decode_simd_matches_scalar() {
+  std::mt19937          rng(12345);
+  static const char     kDigits[] = "0123456789ABCDEFabcdef";
+  std::vector<uint16_t> simd(kMaxBatchWords), scalar(kMaxBatchWords);
+
+  for (int num = 0; num <= 70; num++) {
+    for (int round = 0; round < 20; round++) {
+      std::string text(num * 4, '0');
+      for (char &c : text) {
+        c = kDigits[rng() % 22];
+      }
+      CHECK(decode_hex_words(text.data(), num, simd.data()) ==
+            decode_hex_words_scalar(text.data(), num, scalar.data()));
+      CHECK(memcmp(simd.data(), scalar.data(), num * 2) == 0);
+
+      std::vector<uint16_t> original(num + 1);
+      for (int i = 0; i < num; i++) {
+        original[i] = (uint16_t)rng();
+      }
+      encode_hex_words(original.data(), num, &text[0]);
+      CHECK(decode_hex_words(text.data(), num, simd.data()));
+      CHECK(memcmp(simd.data(), original.data(), num * 2) == 0);
+
+      // Một ký tự sai ở vị trí bất kỳ làm cả hai đường trả về false
+      if (num > 0) {
+        static const char kBad[] = "/:@G`g \xff";
+        text[rng() % text.size()] = kBad[rng() % 8];
+        CHECK(!decode_hex_words(text.data(), num, simd.data()));
+        CHECK(!decode_hex_words_scalar(text.data(), num, scalar.data()));
+      }
+    }
+  }
+
+  std::string full(kMaxBatchWords * 4, 'F');
+  CHECK(decode_hex_words(full.data(), kMaxBatchWords, simd.data()));
+  CHECK(simd[0] == 0xFFFF && simd[kMaxBatchWords - 1] == 0xFFFF);
+}
+
+void test_unpack_bits_simd_matches_scalar() {
+  std::mt19937         rng(54321);
+  std::vector<uint8_t> packed(kMaxBatchBits / 2);
+  std::vector<uint8_t> simd(kMaxBatchBits), scalar(kMaxBatchBits);
+  for (uint8_t &b : packed) {
+    b = (uint8_t)rng();
+  }
+
+  for (int points = 0; points <= 130; points++) {
+    size_t offset = rng() % 64;
+    unpack_bit_nibbles(packed.data() + offset, points, simd.data());
+    unpack_bit_nibbles_scalar(packed.data() + offset, points, scalar.data());
+    CHECK(memcmp(simd.data(), scalar.data(), points) == 0);
+  }
+  unpack_bit_nibbles(packed.data(), kMaxBatchBits, simd.data());
+  unpack_bit_nibbles_scalar(packed.data(), kMaxBatchBits, scalar.data());
+  CHECK(memcmp(simd.data(), scalar.data(), kMaxBatchBits) == 0);
+}
+
+}  // namespace
+
+int main() {
+  test_encode_read();
+  test_encode_read_bits();
+  test_encode_write();
+  test_encode_rejects();
+  test_decode_response();
+  test_error_end_code();
+  test_truncated_response();
+  test_decode_bits();
+  test_hex_decode_simd_matches_scalar();
+  test_unpack_bits_simd_matches_scalar();
+  return test_result("test_slmp_codec");
+}
@@ -0,0 +1,82 @@
+// Test SnapshotCoordinator trên PLC giả (FakeSlmpServer): dữ liệu của từng
+// PLC, và target thêm vào giữa hai chu kỳ chỉ đọc từ chu kỳ kế tiếp.
+
+#include <chrono>
+#include <thread>
+
+#include "fake_slmp_server.hpp"
+#include "test_common.hpp"
+#include "test_slmp/snapshot_coordinator.hpp"
+
+using namespace plc_slmp;
+
+namespace {
+
+bool connect(PlcClient &plc) {
+  plc.set_backend(PlcBackend::NATIVE);
+  return plc.init_plc();
+}
+
+void test_target_added_between_cycles() {
+  FakeSlmpServer press, conveyor;
+  PlcClient      plc1("127.0.0.1", press.port(), MELCLI_TYPE_TCPIP);
+  PlcClient      plc2("127.0.0.1", conveyor.port(), MELCLI_TYPE_TCPIP);
+  CHECK(connect(plc1));
+  CHECK(connect(plc2));
+  press.set("D100", 11);
+  conveyor.set("D100", 21);
+
+  SnapshotCoordinator line({{"D100", 4}});
+  CHECK(line.add_target(plc1, "press"));
+
+  Snapshot snap;
+  CHECK(line.snapshot(snap));
+  CHECK(snap.targets.size() == 1);
+  CHECK(snap.targets[0].data[0] == 11);
+  CHECK(press.reads() == 1);
+
+  // Target mới không được đọc cho tới chu kỳ kế tiếp
+  CHECK(line.add_target(plc2, "conveyor"));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  CHECK(conveyor.reads() == 0);
+
+  for (uint16_t cycle = 0; cycle < 20; cycle++) {
+    press.set("D100", (uint16_t)(100 + cycle));
+    conveyor.set("D100", (uint16_t)(200 + cycle));
+    CHECK(line.snapshot(snap));
+    CHECK(snap.targets.size() == 2);
+    CHECK(snap.targets[0].name == "press");
+    CHECK(snap.targets[0].data[0] == 100 + cycle);
+    CHECK(snap.targets[1].name == "conveyor");
+    CHECK(snap.targets[1].data[0] == 200 + cycle);
+  }
+  CHECK(press.reads() == 21);
+  CHECK(conveyor.reads() == 20);
+}
+
+void test_failed_target() {
+  FakeSlmpServer server;
+  PlcClient      good("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  PlcClient      offline("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  CHECK(connect(good));
+  offline.set_backend(PlcBackend::NATIVE);
+
+  SnapshotCoordinator line({{"D0", 2}, {"D500", 3}});
+  CHECK(line.add_target(good, "good"));
+  CHECK(line.add_target(offline, "offline"));
+  server.set("D501", 7);
+
+  Snapshot snap;
+  CHECK(!line.snapshot(snap));
+  CHECK(snap.targets[0].ok);
+  CHECK(!snap.targets[1].ok);
+  CHECK(snap.targets[0].data[line.block_offset(1) + 1] == 7);
+}
+
+}  // namespace
+
+int main() {
+  test_target_added_between_cycles();
+  test_failed_target();
+  return test_result("test_snapshot_coordinator");
+}
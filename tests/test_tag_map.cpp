@@ -0,0 +1,85 @@
+// Kiểm tra TagMap lúc biên dịch: tra tên tag, kế hoạch đọc gộp frame.
+// Các lỗi khai báo (địa chỉ sai, trùng tên, chồng thanh ghi) nằm trong
+// tag_map_compile_fail.cpp và được kiểm tra bằng các test WILL_FAIL.
+
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+#include "test_slmp/tag_map.hpp"
+
+using namespace plc_slmp;
+
+namespace {
+
+constexpr bool same(const char *a, const char *b) {
+  while (*a != '\0' && *a == *b) {
+    a++;
+    b++;
+  }
+  return *a == *b;
+}
+
+constexpr TagMap kMap{Tag<int32_t>("D100", "speed"),
+                      Tag<uint16_t>("D102", "mode"),
+                      Tag<float>("D110", "temp"),
+                      Tag<bool>("M5", "run"),
+                      Tag<bool>("M20", "alarm"),
+                      Tag<int16_t>("D2000", "far")};
+
+// Tra tên tag theo vị trí trong Values
+static_assert(kMap.index_of("speed") == 0, "lookup speed");
+static_assert(kMap.index_of("temp") == 2, "lookup temp");
+static_assert(kMap.index_of("far") == 5, "lookup far");
+static_assert(std::is_same<std::tuple_element_t<kMap.index_of("run"),
+                                                decltype(kMap)::Values>,
+                           bool>::value,
+              "tag type follows the declaration");
+
+// D100..D111 gộp một frame, D2000 cách D100 quá kMaxBatchWords word nên
+// tách frame riêng, M5 và M20 nằm trong M0..M31 (2 word)
+static_assert(kMap.frame_count() == 3, "three frames");
+static_assert(same(kMap.frame(0).addr, "D100"), "frame 0 address");
+static_assert(kMap.frame(0).num == 12, "frame 0 covers D100..D111");
+static_assert(kMap.frame(0).offset == 0, "frame 0 offset");
+static_assert(same(kMap.frame(1).addr, "D2000"), "frame 1 address");
+static_assert(kMap.frame(1).num == 1, "frame 1 size");
+static_assert(same(kMap.frame(2).addr, "M0"), "frame 2 address");
+static_assert(kMap.frame(2).num == 2, "frame 2 covers M0..M31");
+static_assert(kMap.word_count() == 15, "buffer size");
+
+// Tag liền kề không chồng nhau là hợp lệ
+constexpr TagMap kAdjacent{Tag<uint32_t>("D0", "a"), Tag<uint32_t>("D2", "b")};
+static_assert(kAdjacent.frame_count() == 1, "adjacent tags share a frame");
+static_assert(kAdjacent.word_count() == 4, "adjacent tags");
+
+// Tag bit khác điểm trong cùng một word là hợp lệ
+constexpr TagMap kBits{Tag<bool>("X0", "x0"), Tag<bool>("X1", "x1")};
+static_assert(kBits.word_count() == 1, "bits share a word");
+
+}  // namespace
+
+int main() {
+  // Kiểm tra giải mã lúc chạy trên buffer giả lập kết quả read_chunks
+  uint16_t buffer[15] = {};
+  buffer[0]  = 0x5678;  // speed thấp
+  buffer[1]  = 0x1234;  // speed cao
+  buffer[2]  = 7;       // mode
+  buffer[12] = 0xFFFE;  // far (D2000)
+  buffer[13] = 1 << 5;  // M5
+  buffer[14] = 1 << 4;  // M20
+
+  float temp = 1.5f;
+  memcpy(&buffer[10], &temp, sizeof(temp));
+
+  decltype(kMap)::Values values;
+  kMap.decode(values, buffer);
+  if (std::get<0>(values) != 0x12345678 || std::get<1>(values) != 7 ||
+      std::get<2>(values) != 1.5f || !std::get<3>(values) ||
+      !std::get<4>(values) || std::get<5>(values) != -2) {
+    std::cerr << "TagMap decode mismatch" << std::endl;
+    return 1;
+  }
+  std::cout << "test_tag_map passed" << std::endl;
+  return 0;
+}
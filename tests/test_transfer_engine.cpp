@@ -0,0 +1,186 @@
+// Test TransferEngine trên PLC giả (FakeSlmpServer): vùng dài hơn một frame
+// được chia thành nhiều frame, và read_ranges gộp các vùng gần nhau thành
+// một lần đọc.
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "fake_slmp_server.hpp"
+#include "test_common.hpp"
+#include "test_slmp/transfer_engine.hpp"
+
+using namespace plc_slmp;
+
+namespace {
+
+// Ghi lại số word của từng frame PLC giả nhận được
+class FrameLog {
+public:
+  explicit FrameLog(FakeSlmpServer &server) {
+    server.set_hook([this](const DeviceAddress &, int num, bool write) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      (write ? writes_ : reads_).push_back(num);
+    });
+  }
+
+  std::vector<int> reads() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reads_;
+  }
+
+  std::vector<int> writes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return writes_;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reads_.clear();
+    writes_.clear();
+  }
+
+private:
+  std::mutex       mutex_;
+  std::vector<int> reads_;
+  std::vector<int> writes_;
+};
+
+std::string d_register(int number) {
+  return "D" + std::to_string(number);
+}
+
+void fill(FakeSlmpServer &server, int first, int count) {
+  for (int i = first; i < first + count; i++) {
+    server.set(d_register(i).c_str(), (uint16_t)(i * 3 + 1));
+  }
+}
+
+void test_split_long_range() {
+  FakeSlmpServer server;
+  FrameLog       frames(server);
+  PlcClient      plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  plc.set_backend(PlcBackend::NATIVE);
+  CHECK(plc.init_plc());
+  fill(server, 0, 2500);
+
+  // 2500 word: hai frame 960 word và một frame 580 word
+  TransferEngine        engine(plc);
+  std::vector<uint16_t> data;
+  CHECK(engine.read_range("D0", 2500, data));
+  CHECK(data.size() == 2500);
+  bool same = true;
+  for (int i = 0; i < 2500; i++) {
+    same = same && data[i] == (uint16_t)(i * 3 + 1);
+  }
+  CHECK(same);
+  CHECK(frames.reads() == std::vector<int>({960, 960, 580}));
+
+  // Pipeline không đổi cách chia frame
+  TransferParams params;
+  params.pipeline_depth = 4;
+  engine.set_params(params);
+  std::vector<uint16_t> again;
+  CHECK(engine.read_range("D0", 2500, again));
+  CHECK(again == data);
+  CHECK(server.reads() == 6);
+
+  // Giới hạn frame nhỏ hơn
+  frames.clear();
+  params.max_frame_words = 100;
+  engine.set_params(params);
+  CHECK(engine.read_range("D1000", 250, again));
+  CHECK(again[0] == 1000 * 3 + 1);
+  CHECK(frames.reads() == std::vector<int>({100, 100, 50}));
+
+  // Ghi cũng được chia frame
+  frames.clear();
+  engine.set_params(TransferParams{});
+  std::vector<uint16_t> written(2000);
+  for (size_t i = 0; i < written.size(); i++) {
+    written[i] = (uint16_t)(50000 + i);
+  }
+  CHECK(engine.write_range("D3000", 2000, written));
+  CHECK(frames.writes() == std::vector<int>({960, 960, 80}));
+  CHECK(server.get("D3000") == 50000);
+  CHECK(server.get("D3959") == 50959);
+  CHECK(server.get("D3960") == 50960);
+  CHECK(server.get("D4999") == 51999);
+}
+
+void test_coalesce_ranges() {
+  FakeSlmpServer server;
+  FrameLog       frames(server);
+  PlcClient      plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  plc.set_backend(PlcBackend::NATIVE);
+  CHECK(plc.init_plc());
+  fill(server, 0, 6000);
+  server.set("M32", 0x00F0);
+
+  TransferParams params;
+  params.coalesce_gap = 8;
+  TransferEngine engine(plc, params);
+
+  // D100-D109 và D115-D119 cách nhau 5 word nên được gộp; D5000 ở xa và M
+  // là loại thiết bị khác nên đọc riêng
+  uint16_t  a[10], b[5], c[3], m[1];
+  RangeRead ranges[] = {
+    {"D5000", 3, c},
+    {"D115", 5, b},
+    {"M32", 1, m},
+    {"D100", 10, a},
+  };
+  CHECK(engine.read_ranges(ranges, 4));
+  CHECK(frames.reads() == std::vector<int>({20, 3, 1}));
+  CHECK(a[0] == 100 * 3 + 1 && a[9] == 109 * 3 + 1);
+  CHECK(b[0] == 115 * 3 + 1 && b[4] == 119 * 3 + 1);
+  CHECK(c[0] == 5000 * 3 + 1 && c[2] == 5002 * 3 + 1);
+  CHECK(m[0] == 0x00F0);
+
+  // Khoảng trống lớn hơn coalesce_gap: không gộp
+  frames.clear();
+  params.coalesce_gap = 4;
+  engine.set_params(params);
+  CHECK(engine.read_ranges(ranges + 1, 1));
+  CHECK(engine.read_ranges(ranges, 4));
+  CHECK(frames.reads().size() == 5);
+
+  // Vùng gộp vượt quá một frame vẫn được chia
+  frames.clear();
+  params.coalesce_gap = 100;
+  engine.set_params(params);
+  std::vector<uint16_t> first(900), second(100);
+  RangeRead             wide[] = {
+    {"D0", 900, first.data()},
+    {"D950", 100, second.data()},
+  };
+  CHECK(engine.read_ranges(wide, 2));
+  CHECK(frames.reads() == std::vector<int>({960, 90}));
+  CHECK(first[899] == 899 * 3 + 1);
+  CHECK(second[0] == 950 * 3 + 1 && second[99] == 1049 * 3 + 1);
+}
+
+void test_invalid_ranges() {
+  FakeSlmpServer server;
+  PlcClient      plc("127.0.0.1", server.port(), MELCLI_TYPE_TCPIP);
+  plc.set_backend(PlcBackend::NATIVE);
+  CHECK(plc.init_plc());
+
+  TransferEngine        engine(plc);
+  std::vector<uint16_t> data;
+  CHECK(!engine.read_range("D0", 0, data));
+  CHECK(!engine.read_range("Q0", 10, data));
+  uint16_t  word;
+  RangeRead ranges[] = {{"D0", 1, &word}, {"D10", -1, &word}};
+  CHECK(!engine.read_ranges(ranges, 2));
+  CHECK(server.reads() == 0);
+}
+
+}  // namespace
+
+int main() {
+  test_split_long_range();
+  test_coalesce_ranges();
+  test_invalid_ranges();
+  return test_result("test_transfer_engine");
+}